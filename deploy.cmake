@@ -55,3 +55,21 @@ deploy("wiring_admin" BUNDLES
    ${CELIX_BUNDLES_DIR}/shell_tui.zip
    org.inaetics.wiring_admin.WiringAdmin
 )
+
+deploy("wiring_tcp" BUNDLES
+   ${CELIX_BUNDLES_DIR}/shell.zip
+   ${CELIX_BUNDLES_DIR}/shell_tui.zip
+   org.inaetics.node_discovery.etcd.NodeDiscovery
+   org.inaetics.wiring_topology_manager.WiringTopologyManager
+   org.inaetics.wiring_admin_tcp.WiringAdminTcp
+   org.inaetics.wiring_echoServer
+)
+
+deploy("wiring_shm" BUNDLES
+   ${CELIX_BUNDLES_DIR}/shell.zip
+   ${CELIX_BUNDLES_DIR}/shell_tui.zip
+   org.inaetics.node_discovery.etcd.NodeDiscovery
+   org.inaetics.wiring_topology_manager.WiringTopologyManager
+   org.inaetics.wiring_admin_shm.WiringAdminShm
+   org.inaetics.wiring_echoServer
+)
@@ -8,9 +8,8 @@
 #include <stdbool.h>
 
 
-#define MAX_WIRES			256
-#define MAX_NODES			256
-#define MAX_ZONES			64
+// wires are stored as <root>/<zone>/<node>/<wire>
+#define ETCD_WIRE_DEPTH		3
 
 #define MAX_KEY_LENGTH		256
 #define MAX_VALUE_LENGTH	4096
@@ -26,14 +25,27 @@
 #define ETCD_JSON_KEY			"key"
 #define ETCD_JSON_VALUE			"value"
 #define ETCD_JSON_MODIFIEDINDEX	"modifiedIndex"
+#define ETCD_JSON_ERRORCODE		"errorCode"
+
+#define ETCD_ERROR_KEY_NOT_FOUND	100
+
+// invoked by etcd_getEndpoints for every wire found, the arguments are only valid during the call
+typedef void (*etcd_endpoint_callback_pt)(void* handle, char* key, char* value, int modifiedIndex);
 
 
 
 
 bool etcd_init(char* server, int port);
+void etcd_deinit(void);
 bool etcd_get(char* key, char* value, char*action, int* modifiedIndex);
-bool etcd_getEndpoints(char* directory, char** endpoints, int* size);
+/*
+ * etcdIndex is the index etcd was at when it answered, a watch from etcdIndex + 1 sees every later
+ * change. It is -1 if etcd could not be queried.
+ */
+bool etcd_getEndpoints(char* directory, etcd_endpoint_callback_pt callback, void* handle, int* etcdIndex);
 bool etcd_set(char* key, char* value, int ttl, bool prevExist);
+// returns false without contacting etcd once the server turned out not to support refreshes
+bool etcd_refresh(char* key, char* value, int ttl);
 bool etcd_del(char* key);
 bool etcd_watch(char* key, int index, char* action, char* prevValue, char* value, char* rkey, int *modifiedIndex);
 
@@ -4,57 +4,134 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 #include <curl/curl.h>
 #include <jansson.h>
 
+#include "celix_threads.h"
+
 #include "etcd.h"
+#include "wiring_buffer.h"
 
 #define DEFAULT_CURL_TIMEOUT          10
 #define DEFAULT_CURL_CONECTTIMEOUT    10
+#define DEFAULT_CURL_DNS_CACHE_TIMEOUT    300
+
+// the watcher and the publishers each keep a handle, a few more cover concurrent publishers
+#define MAX_IDLE_CURL_HANDLES         4
+
+#define ETCD_INDEX_HEADER             "X-Etcd-Index:"
 
 typedef enum {
     GET, PUT, DELETE
 } request_t;
 
+typedef enum {
+    REFRESH_UNKNOWN, REFRESH_SUPPORTED, REFRESH_UNSUPPORTED
+} refresh_support_t;
+
 static char* etcd_server = NULL;
 static int etcd_port = 0;
 
-struct MemoryStruct {
-    char *memory;
-    size_t size;
-};
+/*
+ * etcd before 2.3 does not know refresh=true and stores an empty value instead. Support is derived
+ * from the reply to the first refresh, afterwards a missing support is not probed again.
+ */
+static volatile refresh_support_t etcd_refreshSupport = REFRESH_UNKNOWN;
+
+/*
+ * curl handles are kept after a request, so its connection to etcd stays open and the resolved
+ * address cached for the next one. A handle is only used by one request at a time.
+ */
+static celix_thread_mutex_t etcd_curlHandlesLock;
+static CURL* etcd_curlHandles[MAX_IDLE_CURL_HANDLES];
+static int etcd_idleCurlHandles = 0;
+
+static CURL* etcd_acquireCurlHandle(void) {
+    CURL* curl = NULL;
 
-static size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp) {
-    size_t realsize = size * nmemb;
-    struct MemoryStruct *mem = (struct MemoryStruct *) userp;
+    celixThreadMutex_lock(&etcd_curlHandlesLock);
+    if (etcd_idleCurlHandles > 0) {
+        curl = etcd_curlHandles[--etcd_idleCurlHandles];
+    }
+    celixThreadMutex_unlock(&etcd_curlHandlesLock);
 
-    mem->memory = realloc(mem->memory, mem->size + realsize + 1);
-    if (mem->memory == NULL) {
-        /* out of memory! */
-        printf("not enough memory (realloc returned NULL)\n");
-        return 0;
+    // a reset handle keeps its connections and DNS cache, but none of the options of the previous request
+    if (curl != NULL) {
+        curl_easy_reset(curl);
+    } else {
+        curl = curl_easy_init();
     }
 
-    memcpy(&(mem->memory[mem->size]), contents, realsize);
-    mem->size += realsize;
-    mem->memory[mem->size] = 0;
+    return curl;
+}
 
-    return realsize;
+static void etcd_releaseCurlHandle(CURL* curl) {
+    celixThreadMutex_lock(&etcd_curlHandlesLock);
+    if (etcd_idleCurlHandles < MAX_IDLE_CURL_HANDLES) {
+        etcd_curlHandles[etcd_idleCurlHandles++] = curl;
+        curl = NULL;
+    }
+    celixThreadMutex_unlock(&etcd_curlHandlesLock);
+
+    if (curl != NULL) {
+        curl_easy_cleanup(curl);
+    }
 }
 
-static int performRequest(char* url, request_t request, void* callback, void* reqData, void* repData) {
+// picks the index etcd was at when it answered from the reply headers
+static size_t etcd_indexHeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
+    size_t length = size * nitems;
+    size_t headerLength = strlen(ETCD_INDEX_HEADER);
+
+    if (length > headerLength && strncasecmp(buffer, ETCD_INDEX_HEADER, headerLength) == 0) {
+        char field[16];
+        size_t fieldLength = length - headerLength;
+
+        if (fieldLength >= sizeof(field)) {
+            fieldLength = sizeof(field) - 1;
+        }
+
+        memcpy(field, buffer + headerLength, fieldLength);
+        field[fieldLength] = '\0';
+
+        *((int*) userdata) = atoi(field);
+    }
+
+    return length;
+}
+
+// etcdIndex, if not NULL, gets the X-Etcd-Index of the reply and is left untouched if there is none
+static int performRequest(char* url, request_t request, void* reqData, wiring_buffer_pt* repData, int* etcdIndex) {
     CURL *curl = NULL;
     CURLcode res = 0;
 
-    curl = curl_easy_init();
+    // the caller destroys the reply buffer once it is parsed, also if the request failed
+    if (wiringBuffer_create(0, repData) != CELIX_SUCCESS) {
+        return CURLE_OUT_OF_MEMORY;
+    }
+
+    curl = etcd_acquireCurlHandle();
+    if (curl == NULL) {
+        return CURLE_FAILED_INIT;
+    }
+
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, DEFAULT_CURL_TIMEOUT);
     curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, DEFAULT_CURL_CONECTTIMEOUT);
     curl_easy_setopt(curl, CURLOPT_URL, url);
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, repData);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_DNS_CACHE_TIMEOUT, (long) DEFAULT_CURL_DNS_CACHE_TIMEOUT);
+    wiringBuffer_attachToCurl(*repData, curl);
+
+    if (etcdIndex != NULL) {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, etcd_indexHeaderCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, etcdIndex);
+    }
 
     if (request == PUT) {
         curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
@@ -68,7 +145,7 @@ static int performRequest(char* url, request_t request, void* callback, void* re
     }
 
     res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
+    etcd_releaseCurlHandle(curl);
 
     return res;
 }
@@ -77,8 +154,26 @@ static int performRequest(char* url, request_t request, void* callback, void* re
 bool etcd_init(char* server, int port) {
     etcd_server = server;
     etcd_port = port;
+    etcd_refreshSupport = REFRESH_UNKNOWN;
+
+    celixThreadMutex_create(&etcd_curlHandlesLock, NULL);
+
+    // libcurl itself is initialized by the bundle activator
+    return true;
+}
+
+// close, no request may be in progress
+void etcd_deinit(void) {
+    int i;
+
+    celixThreadMutex_lock(&etcd_curlHandlesLock);
+    for (i = 0; i < etcd_idleCurlHandles; i++) {
+        curl_easy_cleanup(etcd_curlHandles[i]);
+    }
+    etcd_idleCurlHandles = 0;
+    celixThreadMutex_unlock(&etcd_curlHandlesLock);
 
-    return curl_global_init(CURL_GLOBAL_ALL) == 0;
+    celixThreadMutex_destroy(&etcd_curlHandlesLock);
 }
 
 // get
@@ -89,18 +184,15 @@ bool etcd_get(char* key, char* value, char* action, int* modifiedIndex) {
     json_t* js_modifiedIndex = NULL;
     json_error_t error;
     int res;
-    struct MemoryStruct reply;
-
-    reply.memory = malloc(1); /* will be grown as needed by the realloc above */
-    reply.size = 0; /* no data at this point */
+    wiring_buffer_pt reply = NULL;
 
     bool retVal = false;
     char url[MAX_URL_LENGTH];
     snprintf(url, MAX_URL_LENGTH, "http://%s:%d/v2/keys/%s", etcd_server, etcd_port, key);
-    res = performRequest(url, GET, WriteMemoryCallback, NULL, (void*) &reply);
+    res = performRequest(url, GET, NULL, &reply, NULL);
 
     if (res == CURLE_OK) {
-        js_root = json_loads(reply.memory, 0, &error);
+        js_root = json_loadb(reply->data, reply->size, 0, &error);
 
         if (js_root != NULL) {
             js_node = json_object_get(js_root, ETCD_JSON_NODE);
@@ -120,91 +212,99 @@ bool etcd_get(char* key, char* value, char* action, int* modifiedIndex) {
         }
     }
 
-    if (reply.memory) {
-        free(reply.memory);
-    }
+    wiringBuffer_destroy(reply);
+
     return retVal;
 }
 
-bool etcd_getEndpoints(char* directory, char** endpoints, int* size) {
+static void etcd_updateHighestModified(json_t* js_node, int* highestModified) {
+    json_t* js_modifiedIndex = json_object_get(js_node, ETCD_JSON_MODIFIEDINDEX);
+
+    if (js_modifiedIndex != NULL && json_is_integer(js_modifiedIndex) && json_integer_value(js_modifiedIndex) > *highestModified) {
+        *highestModified = json_integer_value(js_modifiedIndex);
+    }
+}
+
+/*
+ * Walks the listing below a directory node. Keys and values are handed to the callback as they are
+ * found in the parsed reply, so nothing is copied and there is no limit on the number of entries.
+ */
+static void etcd_visitNodes(json_t* js_dir, int depth, etcd_endpoint_callback_pt callback, void* handle, int* highestModified) {
+    json_t* js_nodes = json_object_get(js_dir, ETCD_JSON_NODES);
+    size_t i;
+
+    etcd_updateHighestModified(js_dir, highestModified);
+
+    for (i = 0; js_nodes != NULL && json_is_array(js_nodes) && i < json_array_size(js_nodes); ++i) {
+        json_t* js_node = json_array_get(js_nodes, i);
+
+        if (!json_is_object(js_node)) {
+            continue;
+        }
+
+        if (depth + 1 < ETCD_WIRE_DEPTH) {
+            etcd_visitNodes(js_node, depth + 1, callback, handle, highestModified);
+        } else {
+            json_t* js_key = json_object_get(js_node, ETCD_JSON_KEY);
+            json_t* js_value = json_object_get(js_node, ETCD_JSON_VALUE);
+            json_t* js_modifiedIndex = json_object_get(js_node, ETCD_JSON_MODIFIEDINDEX);
+
+            etcd_updateHighestModified(js_node, highestModified);
+
+            if (js_key != NULL && json_is_string(js_key) && js_value != NULL && json_is_string(js_value)) {
+                callback(handle, (char*) json_string_value(js_key), (char*) json_string_value(js_value), json_integer_value(js_modifiedIndex));
+            }
+        }
+    }
+}
+
+/*
+ * A single recursive listing returns every wire with its value, so no per-key requests are needed.
+ * Returns false if etcd could not be queried; a missing directory is an empty listing.
+ */
+bool etcd_getEndpoints(char* directory, etcd_endpoint_callback_pt callback, void* handle, int* etcdIndex) {
     json_t* js_root = NULL;
     json_t* js_rootnode = NULL;
-    json_t* js_zones = NULL;
 
     json_error_t error;
     int res;
-    struct MemoryStruct reply;
+    wiring_buffer_pt reply = NULL;
 
-    reply.memory = malloc(1); /* will be grown as needed by the realloc above */
-    reply.size = 0; /* no data at this point */
+    int highestModified = -1;
 
-    *size = 0;
+    *etcdIndex = -1;
 
     bool retVal = false;
     char url[MAX_URL_LENGTH];
 
     snprintf(url, MAX_URL_LENGTH, "http://%s:%d/v2/keys/%s?recursive=true", etcd_server, etcd_port, directory);
 
-    res = performRequest(url, GET, WriteMemoryCallback, NULL, (void*) &reply);
+    res = performRequest(url, GET, NULL, &reply, etcdIndex);
 
     if (res == CURLE_OK) {
 
-        js_root = json_loads(reply.memory, 0, &error);
+        js_root = json_loadb(reply->data, reply->size, 0, &error);
 
         if (js_root != NULL) {
             js_rootnode = json_object_get(js_root, ETCD_JSON_NODE);
+            retVal = (js_rootnode != NULL || json_integer_value(json_object_get(js_root, ETCD_JSON_ERRORCODE)) == ETCD_ERROR_KEY_NOT_FOUND);
         }
         if (js_rootnode != NULL) {
-            js_zones = json_object_get(js_rootnode, ETCD_JSON_NODES);
+            etcd_visitNodes(js_rootnode, 0, callback, handle, &highestModified);
         }
 
-        if (js_zones != NULL && json_is_array(js_zones)) {
-            int i = 0;
-
-            for (i = 0; i < json_array_size(js_zones) && i < MAX_ZONES; ++i) {
-                json_t* js_zone = json_array_get(js_zones, i);
-                json_t* js_nodes = NULL;
-
-                if (js_zone != NULL) {
-                    js_nodes = json_object_get(js_zone, ETCD_JSON_NODES);
-                }
-
-                if (js_nodes != NULL && json_is_array(js_nodes)) {
-                    int j = 0;
-
-                    for (j = 0; j < json_array_size(js_nodes) && j < MAX_NODES; ++j) {
-                        json_t* js_node = json_array_get(js_nodes, j);
-                        json_t* js_wires = NULL;
-
-                        if (js_node != NULL) {
-                            js_wires = json_object_get(js_node, ETCD_JSON_NODES);
-                        }
-
-                        if (js_wires != NULL && json_is_array(js_wires)) {
-                            int k = 0;
-
-                            for (k = 0; k < json_array_size(js_wires) && k < MAX_WIRES; ++k) {
-                                json_t* js_user = json_array_get(js_wires, k);
-
-                                if (json_is_object(js_user)) {
-                                    retVal = true;
-                                    json_t* js_key = json_object_get(js_user, ETCD_JSON_KEY);
-                                    strncpy(endpoints[*size], json_string_value(js_key), MAX_KEY_LENGTH);
-                                    ++(*size);
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
         if (js_root != NULL) {
             json_decref(js_root);
         }
     }
 
-    if (reply.memory) {
-        free(reply.memory);
+    wiringBuffer_destroy(reply);
+
+    // without the header, the newest key of the listing is the best guess
+    if (!retVal) {
+        *etcdIndex = -1;
+    } else if (*etcdIndex < highestModified) {
+        *etcdIndex = highestModified;
     }
 
     return retVal;
@@ -220,10 +320,7 @@ bool etcd_set(char* key, char* value, int ttl, bool prevExist) {
     char request[MAX_CONTENT_LENGTH];
     char* requestPtr = request;
     int res;
-    struct MemoryStruct reply;
-
-    reply.memory = malloc(1); /* will be grown as needed by the realloc above */
-    reply.size = 0; /* no data at this point */
+    wiring_buffer_pt reply = NULL;
 
     snprintf(url, MAX_URL_LENGTH, "http://%s:%d/v2/keys/%s", etcd_server, etcd_port, key);
     requestPtr += snprintf(requestPtr, MAX_CONTENT_LENGTH, "value=%s", value);
@@ -236,10 +333,10 @@ bool etcd_set(char* key, char* value, int ttl, bool prevExist) {
         requestPtr += snprintf(requestPtr, MAX_CONTENT_LENGTH, ";prevExist=true");
     }
 
-    res = performRequest(url, PUT, WriteMemoryCallback, request, (void*) &reply);
+    res = performRequest(url, PUT, request, &reply, NULL);
 
     if (res == CURLE_OK) {
-        js_root = json_loads(reply.memory, 0, &error);
+        js_root = json_loadb(reply->data, reply->size, 0, &error);
 
         if (js_root != NULL) {
             js_node = json_object_get(js_root, ETCD_JSON_NODE);
@@ -255,10 +352,62 @@ bool etcd_set(char* key, char* value, int ttl, bool prevExist) {
         }
     }
 
-    if (reply.memory) {
-        free(reply.memory);
+    wiringBuffer_destroy(reply);
+
+    return retVal;
+}
+
+/*
+ * Extends the ttl of an existing key without rewriting it, which does not notify watchers. Fails if
+ * the key does not exist (anymore) or does not hold value; etcd versions without refresh support
+ * store an empty value instead, the caller is expected to set the key again then.
+ */
+bool etcd_refresh(char* key, char* value, int ttl) {
+    json_error_t error;
+    json_t* js_root = NULL;
+    json_t* js_node = NULL;
+    json_t* js_value = NULL;
+    bool retVal = false;
+    char url[MAX_URL_LENGTH];
+    char request[MAX_CONTENT_LENGTH];
+    int res;
+    wiring_buffer_pt reply = NULL;
+
+    if (etcd_refreshSupport == REFRESH_UNSUPPORTED) {
+        return false;
+    }
+
+    snprintf(url, MAX_URL_LENGTH, "http://%s:%d/v2/keys/%s", etcd_server, etcd_port, key);
+    snprintf(request, MAX_CONTENT_LENGTH, "ttl=%d;refresh=true;prevExist=true", ttl);
+
+    res = performRequest(url, PUT, request, &reply, NULL);
+
+    if (res == CURLE_OK) {
+        js_root = json_loadb(reply->data, reply->size, 0, &error);
+
+        if (js_root != NULL) {
+            js_node = json_object_get(js_root, ETCD_JSON_NODE);
+        }
+        if (js_node != NULL) {
+            js_value = json_object_get(js_node, ETCD_JSON_VALUE);
+        }
+        if (js_value != NULL && json_is_string(js_value)) {
+            retVal = (strcmp(json_string_value(js_value), value) == 0);
+
+            if (retVal) {
+                etcd_refreshSupport = REFRESH_SUPPORTED;
+            } else if (etcd_refreshSupport == REFRESH_UNKNOWN && strlen(json_string_value(js_value)) == 0 && strlen(value) > 0) {
+                printf("NODE_DISCOVERY: refreshing a ttl is not supported by %s:%d, values are rewritten instead\n", etcd_server, etcd_port);
+                etcd_refreshSupport = REFRESH_UNSUPPORTED;
+            }
+        }
+        if (js_root != NULL) {
+            json_decref(js_root);
+        }
     }
 
+    wiringBuffer_destroy(reply);
+
     return retVal;
 }
 
@@ -271,16 +420,13 @@ bool etcd_del(char* key) {
     char url[MAX_URL_LENGTH];
     char request[MAX_CONTENT_LENGTH];
     int res;
-    struct MemoryStruct reply;
-
-    reply.memory = malloc(1); /* will be grown as needed by the realloc above */
-    reply.size = 0; /* no data at this point */
+    wiring_buffer_pt reply = NULL;
 
     snprintf(url, MAX_URL_LENGTH, "http://%s:%d/v2/keys/%s?recursive=true", etcd_server, etcd_port, key);
-    res = performRequest(url, DELETE, WriteMemoryCallback, request, (void*) &reply);
+    res = performRequest(url, DELETE, request, &reply, NULL);
 
     if (res == CURLE_OK) {
-        js_root = json_loads(reply.memory, 0, &error);
+        js_root = json_loadb(reply->data, reply->size, 0, &error);
 
         if (js_root != NULL) {
             js_node = json_object_get(js_root, ETCD_JSON_NODE);
@@ -293,9 +439,7 @@ bool etcd_del(char* key) {
         }
     }
 
-    if (reply.memory) {
-        free(reply.memory);
-    }
+    wiringBuffer_destroy(reply);
 
     return retVal;
 }
@@ -314,21 +458,18 @@ bool etcd_watch(char* key, int index, char* action, char* prevValue, char* value
     bool retVal = false;
     char url[MAX_URL_LENGTH];
     int res;
-    struct MemoryStruct reply;
-
-    reply.memory = malloc(1); /* will be grown as needed by the realloc above */
-    reply.size = 0; /* no data at this point */
+    wiring_buffer_pt reply = NULL;
 
     if (index != 0)
         snprintf(url, MAX_URL_LENGTH, "http://%s:%d/v2/keys/%s?wait=true&recursive=true&waitIndex=%d", etcd_server, etcd_port, key, index);
     else
         snprintf(url, MAX_URL_LENGTH, "http://%s:%d/v2/keys/%s?wait=true&recursive=true", etcd_server, etcd_port, key);
 
-    res = performRequest(url, GET, WriteMemoryCallback, NULL, (void*) &reply);
+    res = performRequest(url, GET, NULL, &reply, NULL);
 
     if (res == CURLE_OK) {
 
-        js_root = json_loads(reply.memory, 0, &error);
+        js_root = json_loadb(reply->data, reply->size, 0, &error);
 
         if (js_root != NULL) {
             js_action = json_object_get(js_root, ETCD_JSON_ACTION);
@@ -370,9 +511,7 @@ bool etcd_watch(char* key, int index, char* action, char* prevValue, char* value
 
     }
 
-    if (reply.memory) {
-        free(reply.memory);
-    }
+    wiringBuffer_destroy(reply);
 
     return retVal;
 }
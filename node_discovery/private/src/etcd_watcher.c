@@ -26,8 +26,22 @@ struct etcd_watcher {
     celix_thread_t watcherThread;
 
     volatile bool running;
+
+    // mirror of the wires in etcd as published to node discovery, only used by the watcher thread
+    hash_map_pt entries; //key=etcd key, value=etcd_watcher_entry
+    unsigned int generation;
+
+    // values of our own wires as last written to etcd
+    celix_thread_mutex_t publishedValuesLock;
+    hash_map_pt publishedValues; //key=etcd key, value=etcd value
 };
 
+typedef struct etcd_watcher_entry {
+    char* value;
+    int modifiedIndex;
+    unsigned int generation; // generation of the last resync which found the key
+} * etcd_watcher_entry_pt;
+
 #define MAX_ROOTNODE_LENGTH		 64
 #define MAX_LOCALNODE_LENGTH 	4096
 
@@ -73,56 +87,123 @@ static celix_status_t etcdWatcher_getLocalNodePath(bundle_context_pt context, no
     return status;
 }
 
-static celix_status_t etcdWatcher_addAlreadyExistingNodes(node_discovery_pt node_discovery, int* highestModified) {
-    celix_status_t status = CELIX_SUCCESS;
-    char** endpointArray = calloc(MAX_NODES, sizeof(*endpointArray));
-    char rootPath[MAX_ROOTNODE_LENGTH];
-    int i, size;
+// a NULL value removes the wire of the key from node discovery
+static void etcdWatcher_publishEntry(node_discovery_pt node_discovery, char* key, char* value) {
+    node_description_pt nodeDescription = NULL;
 
-    *highestModified = -1;
+    if (etcdWatcher_getWiringEndpointFromKey(node_discovery, key, value, &nodeDescription) == CELIX_SUCCESS) {
+        if (value != NULL) {
+            node_discovery_addNode(node_discovery, nodeDescription);
+        } else {
+            node_discovery_removeNode(node_discovery, nodeDescription);
+            nodeDescription_destroy(nodeDescription, true);
+        }
+    }
+}
 
-    if (!endpointArray) {
-        status = CELIX_ENOMEM;
-    } else {
+/*
+ * Records the current state of a wire key. Node discovery is only informed if the key is new or its
+ * value changed; refreshing a key with the same value only bumps its modifiedIndex.
+ */
+static void etcdWatcher_updateEntry(void* handle, char* key, char* value, int modifiedIndex) {
+    etcd_watcher_pt watcher = handle;
+    etcd_watcher_entry_pt entry = hashMap_get(watcher->entries, key);
+
+    if (entry == NULL) {
+        entry = calloc(1, sizeof(*entry));
+
+        if (entry != NULL) {
+            entry->value = strdup(value);
+            entry->modifiedIndex = modifiedIndex;
 
-        for (i = 0; i < MAX_NODES; i++) {
-            endpointArray[i] = calloc(MAX_KEY_LENGTH, sizeof(*endpointArray[i]));
+            hashMap_put(watcher->entries, strdup(key), entry);
+            etcdWatcher_publishEntry(watcher->node_discovery, key, value);
         }
+    } else if (entry->modifiedIndex != modifiedIndex) {
+        entry->modifiedIndex = modifiedIndex;
 
-        // we need to go though all nodes and get the highest modifiedIndex
-        if (((status = etcdWatcher_getRootPath(node_discovery->context, &rootPath[0])) == CELIX_SUCCESS) && (etcd_getEndpoints(rootPath, endpointArray, &size) == true)) {
-            for (i = 0; i < size; i++) {
-                node_description_pt nodeDescription = NULL;
+        if (strcmp(entry->value, value) != 0) {
+            free(entry->value);
+            entry->value = strdup(value);
 
-                char* key = endpointArray[i];
-                int modIndex = 0;
+            // node discovery keeps the first description of a wire, so a changed one is re-added
+            etcdWatcher_publishEntry(watcher->node_discovery, key, NULL);
+            etcdWatcher_publishEntry(watcher->node_discovery, key, value);
+        }
+    }
 
-                // check for key ..
+    if (entry != NULL) {
+        entry->generation = watcher->generation;
+    }
+}
 
-                char action[MAX_ACTION_LENGTH];
-                char etcdValue[MAX_VALUE_LENGTH];
+// removes the key and, if it is a directory such as a node, all keys below it
+static void etcdWatcher_removeEntries(etcd_watcher_pt watcher, char* key) {
+    size_t keyLength = strlen(key);
+    hash_map_iterator_pt iter = hashMapIterator_create(watcher->entries);
 
-                if (etcd_get(key, &etcdValue[0], &action[0], &modIndex) != true) {
-                    printf("NODE_DISCOVERY: Could not retrieve value for %s\n", key);
-                    status = CELIX_ILLEGAL_STATE;
-                }
-                else  {
-                    status = etcdWatcher_getWiringEndpointFromKey(node_discovery, key, &etcdValue[0], &nodeDescription);
+    while (hashMapIterator_hasNext(iter)) {
+        hash_map_entry_pt mapEntry = hashMapIterator_nextEntry(iter);
+        char* entryKey = hashMapEntry_getKey(mapEntry);
 
-                    node_discovery_addNode(node_discovery, nodeDescription);
-                }
+        if (strncmp(entryKey, key, keyLength) == 0 && (entryKey[keyLength] == '\0' || entryKey[keyLength] == '/')) {
+            etcd_watcher_entry_pt entry = hashMapEntry_getValue(mapEntry);
+
+            etcdWatcher_publishEntry(watcher->node_discovery, entryKey, NULL);
+
+            hashMapIterator_remove(iter);
+            free(entry->value);
+            free(entry);
+            free(entryKey);
+        }
+    }
+
+    hashMapIterator_destroy(iter);
+}
+
+/*
+ * Compares a snapshot of etcd, taken with a single recursive request, with the mirror and only
+ * publishes the differences. Wires which disappeared without the watch noticing, e.g. because
+ * their events were missed, are removed. The watch continues after the snapshot, it never goes
+ * back to events that were already seen.
+ */
+static celix_status_t etcdWatcher_resync(etcd_watcher_pt watcher, int* highestModified) {
+    celix_status_t status = CELIX_SUCCESS;
+    char rootPath[MAX_ROOTNODE_LENGTH];
+    int snapshotIndex = -1;
+
+    watcher->generation++;
+
+    if ((status = etcdWatcher_getRootPath(watcher->node_discovery->context, &rootPath[0])) != CELIX_SUCCESS) {
+        // nothing to do
+    } else if (etcd_getEndpoints(rootPath, etcdWatcher_updateEntry, watcher, &snapshotIndex) == false) {
+        status = CELIX_ILLEGAL_STATE;
+    } else {
+        hash_map_iterator_pt iter = hashMapIterator_create(watcher->entries);
+
+        while (hashMapIterator_hasNext(iter)) {
+            hash_map_entry_pt mapEntry = hashMapIterator_nextEntry(iter);
+            etcd_watcher_entry_pt entry = hashMapEntry_getValue(mapEntry);
 
-                *highestModified = modIndex;
+            if (entry->generation != watcher->generation) {
+                char* entryKey = hashMapEntry_getKey(mapEntry);
+
+                etcdWatcher_publishEntry(watcher->node_discovery, entryKey, NULL);
+
+                hashMapIterator_remove(iter);
+                free(entry->value);
+                free(entry);
+                free(entryKey);
             }
         }
 
-        for (i = 0; i < MAX_NODES; i++) {
-            free(endpointArray[i]);
+        hashMapIterator_destroy(iter);
+
+        if (snapshotIndex > *highestModified) {
+            *highestModified = snapshotIndex;
         }
     }
 
-    free(endpointArray);
-
     return status;
 }
 
@@ -151,6 +232,11 @@ celix_status_t etcdWatcher_addOwnNode(etcd_watcher_pt watcher) {
         }
     }
 
+    celixThreadMutex_lock(&watcher->publishedValuesLock);
+
+    // wires which are no longer registered are dropped from the published values
+    hash_map_pt publishedValues = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
     // register every wiring endpoint
     array_list_iterator_pt endpointIter = arrayListIterator_create(ownNodeDescription->wiring_ep_descriptions_list);
 
@@ -168,13 +254,23 @@ celix_status_t etcdWatcher_addOwnNode(etcd_watcher_pt watcher) {
 
             snprintf(etcdKey, MAX_LOCALNODE_LENGTH, "%s/%s", localNodePath, wireId);
 
-            // TODO : implement update
-            etcd_set(etcdKey, etcdValue, ttl, false);
+            char* publishedValue = hashMap_get(watcher->publishedValues, etcdKey);
+            bool unchanged = (publishedValue != NULL && strcmp(publishedValue, etcdValue) == 0);
+
+            // an unchanged wire only gets its ttl refreshed, which causes no watch events on other nodes
+            if ((unchanged && etcd_refresh(etcdKey, etcdValue, ttl)) || etcd_set(etcdKey, etcdValue, ttl, false)) {
+                hashMap_put(publishedValues, strdup(etcdKey), strdup(etcdValue));
+            }
         }
     }
 
     arrayListIterator_destroy(endpointIter);
 
+    hashMap_destroy(watcher->publishedValues, true, true);
+    watcher->publishedValues = publishedValues;
+
+    celixThreadMutex_unlock(&watcher->publishedValuesLock);
+
     return status;
 }
 
@@ -235,14 +331,15 @@ static void* etcdWatcher_run(void* data) {
     etcd_watcher_pt watcher = (etcd_watcher_pt) data;
     time_t timeBeforeWatch = time(NULL);
     char rootPath[MAX_ROOTNODE_LENGTH];
-    int highestModified = 0;
+    // -1 watches from now on until a snapshot succeeded, rather than replaying the whole history
+    int highestModified = -1;
 
     node_discovery_pt node_discovery = watcher->node_discovery;
     bundle_context_pt context = node_discovery->context;
 
     memset(rootPath, 0, MAX_ROOTNODE_LENGTH);
 
-    etcdWatcher_addAlreadyExistingNodes(node_discovery, &highestModified);
+    etcdWatcher_resync(watcher, &highestModified);
     etcdWatcher_getRootPath(context, rootPath);
 
     while ((celixThreadMutex_lock(&watcher->watcherLock) == CELIX_SUCCESS) && watcher->running) {
@@ -256,32 +353,10 @@ static void* etcdWatcher_run(void* data) {
         celixThreadMutex_unlock(&watcher->watcherLock);
 
         if (etcd_watch(rootPath, highestModified + 1, &action[0], &preValue[0], &value[0], &rkey[0], &modIndex) == true) {
-            if ((strcmp(action, "set") == 0) || (strcmp(action, "create") == 0)) {
-                node_description_pt nodeDescription = NULL;
-                celix_status_t status = etcdWatcher_getWiringEndpointFromKey(node_discovery, &rkey[0], &value[0], &nodeDescription);
-
-                if (status == CELIX_SUCCESS) {
-                    node_discovery_addNode(node_discovery, nodeDescription);
-                }
-            } else if (strcmp(action, "delete") == 0) {
-                node_description_pt nodeDescription = NULL;
-                celix_status_t status = etcdWatcher_getWiringEndpointFromKey(node_discovery, &rkey[0], NULL, &nodeDescription);
-                if (status == CELIX_SUCCESS) {
-                    node_discovery_removeNode(node_discovery, nodeDescription);
-                }
-            } else if (strcmp(action, "expire") == 0) {
-                node_description_pt nodeDescription = NULL;
-                celix_status_t status = etcdWatcher_getWiringEndpointFromKey(node_discovery, &rkey[0], NULL, &nodeDescription);
-                if (status == CELIX_SUCCESS) {
-                    node_discovery_removeNode(node_discovery, nodeDescription);
-                }
-            } else if (strcmp(action, "update") == 0) {
-                node_description_pt nodeDescription = NULL;
-                celix_status_t status = etcdWatcher_getWiringEndpointFromKey(node_discovery, &rkey[0], &value[0], &nodeDescription);
-
-                if (status == CELIX_SUCCESS) {
-                    node_discovery_addNode(node_discovery, nodeDescription);
-                }
+            if ((strcmp(action, "set") == 0) || (strcmp(action, "create") == 0) || (strcmp(action, "update") == 0)) {
+                etcdWatcher_updateEntry(watcher, &rkey[0], &value[0], modIndex);
+            } else if ((strcmp(action, "delete") == 0) || (strcmp(action, "expire") == 0)) {
+                etcdWatcher_removeEntries(watcher, &rkey[0]);
             } else {
                 fw_log(logger, OSGI_FRAMEWORK_LOG_INFO, "Unexpected action: %s", action);
             }
@@ -296,8 +371,8 @@ static void* etcdWatcher_run(void* data) {
         if (time(NULL) - timeBeforeWatch > (DEFAULT_ETCD_TTL / 4)) {
             etcdWatcher_addOwnNode(watcher);
 
-            // perform additional full-sync
-            etcdWatcher_addAlreadyExistingNodes(node_discovery, &highestModified);
+            // catch up with changes the watch missed, only differences are published
+            etcdWatcher_resync(watcher, &highestModified);
             timeBeforeWatch = time(NULL);
         }
     }
@@ -324,6 +399,9 @@ celix_status_t etcdWatcher_create(node_discovery_pt node_discovery, bundle_conte
 
     if (*watcher) {
         (*watcher)->node_discovery = node_discovery;
+        (*watcher)->entries = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+        (*watcher)->publishedValues = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+        celixThreadMutex_create(&(*watcher)->publishedValuesLock, NULL);
 
         if ((bundleContext_getProperty(context, CFG_ETCD_SERVER_IP, &etcd_server) != CELIX_SUCCESS) || !etcd_server) {
             etcd_server = DEFAULT_ETCD_SERVER_IP;
@@ -383,6 +461,19 @@ celix_status_t etcdWatcher_destroy(etcd_watcher_pt watcher) {
     celixThread_join(watcher->watcherThread, NULL);
     celixThreadMutex_destroy(&(watcher->watcherLock));
 
+    hash_map_iterator_pt iter = hashMapIterator_create(watcher->entries);
+    while (hashMapIterator_hasNext(iter)) {
+        etcd_watcher_entry_pt entry = hashMapIterator_nextValue(iter);
+
+        free(entry->value);
+        free(entry);
+    }
+    hashMapIterator_destroy(iter);
+    hashMap_destroy(watcher->entries, true, false);
+
+    hashMap_destroy(watcher->publishedValues, true, true);
+    celixThreadMutex_destroy(&(watcher->publishedValuesLock));
+
     // remove own registration
     status = etcdWatcher_getLocalNodePath(watcher->node_discovery->context, watcher->node_discovery->ownNode, &localNodePath[0]);
 
@@ -390,6 +481,8 @@ celix_status_t etcdWatcher_destroy(etcd_watcher_pt watcher) {
         printf("Cannot remove local discovery registration.");
     }
 
+    etcd_deinit();
+
     free(watcher);
 
     return status;
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <curl/curl.h>
+
 #include "bundle_activator.h"
 #include "service_tracker.h"
 #include "service_registration.h"
@@ -53,7 +55,18 @@ celix_status_t bundleActivator_create(bundle_context_pt context, void **userData
 		activator->wiringEndpointListener = NULL;
 		activator->wiringEndpointListenerService = NULL;
 
-		status = node_discovery_create(context, &activator->node_discovery);
+		/*
+		 * The global state of libcurl is shared with the other bundles using it and its setup is not
+		 * thread-safe, so it is done here, before any thread of this bundle runs. It is never cleaned up:
+		 * on stop this bundle cannot know whether another one still has transfers running.
+		 */
+		if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
+			status = CELIX_BUNDLE_EXCEPTION;
+		}
+
+		if (status == CELIX_SUCCESS) {
+			status = node_discovery_create(context, &activator->node_discovery);
+		}
 
 		if (status == CELIX_SUCCESS) {
 			status = createWiringEndpointListenerTracker(activator, &(activator->wiringEndpointListenerTracker));
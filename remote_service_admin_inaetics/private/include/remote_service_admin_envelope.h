@@ -0,0 +1,32 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef REMOTE_SERVICE_ADMIN_ENVELOPE_H_
+#define REMOTE_SERVICE_ADMIN_ENVELOPE_H_
+
+#include <stdlib.h>
+
+#include "celix_errno.h"
+
+/*
+ * The "rsb1" request envelope:
+ *
+ *   "RSB1" | serviceId (16 hex digits) | flags (8 hex digits) | payload length (8 hex digits) | payload
+ *
+ * The envelope has to survive wiring admins that treat requests as strings, so its header is
+ * fixed-width ASCII hex rather than raw binary. The payload follows the header unchanged.
+ */
+#define RSA_INAETICS_ENVELOPE_MAGIC			"RSB1"
+#define RSA_INAETICS_ENVELOPE_HEADER_SIZE	36
+
+// *data is newly allocated and NUL-terminated, *length does not count the terminating NUL
+celix_status_t remoteServiceAdmin_createEnvelope(long serviceId, unsigned int flags, const char* payload, char** data, size_t* length);
+
+/*
+ * data has to start with RSA_INAETICS_ENVELOPE_MAGIC. *payload points into data. Returns
+ * CELIX_ILLEGAL_ARGUMENT if the header is malformed or does not match the length of the payload.
+ */
+celix_status_t remoteServiceAdmin_parseEnvelope(char* data, long* serviceId, unsigned int* flags, char** payload);
+
+#endif /* REMOTE_SERVICE_ADMIN_ENVELOPE_H_ */
@@ -8,8 +8,18 @@
 #include "remote_service_admin_impl.h"
 #include "wiring_endpoint_description.h"
 #include "wiring_endpoint_listener.h"
+#include "wiring_admin.h"
 #include "log_helper.h"
 #include "service_tracker.h"
+#include "remote_service_admin_envelope.h"
+
+/*
+ * Exported endpoints announce the request envelope they understand. Importers of endpoints without
+ * this property fall back to the JSON envelope {"service.id": .., "request": ..}; the receiving side
+ * accepts both. See remote_service_admin_envelope.h for the "rsb1" envelope.
+ */
+#define RSA_INAETICS_ENVELOPE_KEY			"org.inaetics.remote.admin.wiring.envelope"
+#define RSA_INAETICS_ENVELOPE_BINARY		"rsb1"
 
 struct activator {
     remote_service_admin_pt admin;
@@ -23,6 +33,25 @@ struct activator {
     service_tracker_pt wtmTracker;
 };
 
+/*
+ * A tracked wiring send service. remoteServiceAdmin_send only holds sendServicesLock to look up the
+ * entry and take a reference; the send itself runs unlocked. A removed service is taken out of the
+ * map first and released once the last call using it has returned.
+ */
+typedef struct send_service_entry {
+	wiring_send_service_pt service;
+	unsigned int refCount;
+} * send_service_entry_pt;
+
+/*
+ * An export addressed by incoming requests. remoteServiceAdmin_receive takes a reference under
+ * exportIndexLock and calls the endpoint unlocked; removing the export waits for the last request.
+ */
+typedef struct export_index_entry {
+	export_registration_pt registration;
+	unsigned int refCount;
+} * export_index_entry_pt;
+
 struct remote_service_admin {
 	bundle_context_pt context;
 	log_helper_pt loghelper;
@@ -30,6 +59,10 @@ struct remote_service_admin {
 	celix_thread_mutex_t exportedServicesLock;
 	hash_map_pt exportedServices;
 
+	celix_thread_mutex_t exportIndexLock;
+	celix_thread_cond_t exportReleased;
+	hash_map_pt exportIndex; //key=serviceId, value=export_index_entry
+
 	celix_thread_mutex_t importedServicesLock;
 	hash_map_pt importedServices;
 
@@ -40,7 +73,8 @@ struct remote_service_admin {
 
 	service_tracker_pt sendServicesTracker;
 	celix_thread_mutex_t sendServicesLock;
-	hash_map_pt sendServices;
+	celix_thread_cond_t sendServiceReleased;
+	hash_map_pt sendServices; //key=wireId, value=send_service_entry
 
     celix_thread_mutex_t listenerListLock;
     hash_map_pt listenerList;
@@ -0,0 +1,70 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "remote_service_admin_envelope.h"
+
+celix_status_t remoteServiceAdmin_createEnvelope(long serviceId, unsigned int flags, const char* payload, char** data, size_t* length) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    size_t payloadLength = strlen(payload);
+
+    if (payloadLength > 0xFFFFFFFFUL) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else {
+        *data = malloc(RSA_INAETICS_ENVELOPE_HEADER_SIZE + payloadLength + 1);
+
+        if (*data == NULL) {
+            status = CELIX_ENOMEM;
+        } else {
+            snprintf(*data, RSA_INAETICS_ENVELOPE_HEADER_SIZE + 1, "%s%016llx%08x%08lx", RSA_INAETICS_ENVELOPE_MAGIC, (unsigned long long) serviceId, flags, (unsigned long) payloadLength);
+            memcpy(*data + RSA_INAETICS_ENVELOPE_HEADER_SIZE, payload, payloadLength + 1);
+            *length = RSA_INAETICS_ENVELOPE_HEADER_SIZE + payloadLength;
+        }
+    }
+
+    return status;
+}
+
+celix_status_t remoteServiceAdmin_parseEnvelope(char* data, long* serviceId, unsigned int* flags, char** payload) {
+    celix_status_t status = CELIX_ILLEGAL_ARGUMENT;
+
+    char field[17];
+    char* end = NULL;
+    size_t length = strlen(data);
+
+    // strtoul would also accept blanks and signs, the header only holds hex digits
+    if (length >= RSA_INAETICS_ENVELOPE_HEADER_SIZE && strspn(data + strlen(RSA_INAETICS_ENVELOPE_MAGIC), "0123456789abcdefABCDEF") >= RSA_INAETICS_ENVELOPE_HEADER_SIZE - strlen(RSA_INAETICS_ENVELOPE_MAGIC)) {
+        const char* header = data + strlen(RSA_INAETICS_ENVELOPE_MAGIC);
+        unsigned long long id = 0;
+        unsigned long payloadLength = 0;
+
+        memcpy(field, header, 16);
+        field[16] = '\0';
+        id = strtoull(field, &end, 16);
+
+        if (*end == '\0') {
+            memcpy(field, header + 16, 8);
+            field[8] = '\0';
+            *flags = strtoul(field, &end, 16);
+        }
+
+        if (*end == '\0') {
+            memcpy(field, header + 24, 8);
+            field[8] = '\0';
+            payloadLength = strtoul(field, &end, 16);
+        }
+
+        if (*end == '\0' && payloadLength == length - RSA_INAETICS_ENVELOPE_HEADER_SIZE) {
+            *serviceId = (long) id;
+            *payload = data + RSA_INAETICS_ENVELOPE_HEADER_SIZE;
+            status = CELIX_SUCCESS;
+        }
+    }
+
+    return status;
+}
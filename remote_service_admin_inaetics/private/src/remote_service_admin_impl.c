@@ -71,6 +71,7 @@ celix_status_t remoteServiceAdmin_create(bundle_context_pt context, remote_servi
         arrayList_create(&(*admin)->wtmList);
 
         (*admin)->exportedServices = hashMap_create(NULL, NULL, NULL, NULL);
+        (*admin)->exportIndex = hashMap_create(NULL, NULL, NULL, NULL);
         (*admin)->importedServices = hashMap_create(NULL, NULL, NULL, NULL);
         (*admin)->wiringReceiveServices = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
         (*admin)->wiringReceiveServiceRegistrations = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
@@ -83,7 +84,10 @@ celix_status_t remoteServiceAdmin_create(bundle_context_pt context, remote_servi
         status = celixThreadMutex_create(&(*admin)->listenerListLock, NULL);
         celixThreadMutex_create(&(*admin)->wtmListLock, NULL);
         celixThreadMutex_create(&(*admin)->sendServicesLock, NULL);
+        celixThreadCondition_init(&(*admin)->sendServiceReleased, NULL);
         celixThreadMutex_create(&(*admin)->exportedServicesLock, NULL);
+        celixThreadMutex_create(&(*admin)->exportIndexLock, NULL);
+        celixThreadCondition_init(&(*admin)->exportReleased, NULL);
         celixThreadMutex_create(&(*admin)->importedServicesLock, NULL);
 
         if (logHelper_create(context, &(*admin)->loghelper) == CELIX_SUCCESS) {
@@ -105,8 +109,12 @@ celix_status_t remoteServiceAdmin_destroy(remote_service_admin_pt *admin) {
 
     arrayList_destroy((*admin)->exportedWires);
 
+    celixThreadCondition_destroy(&(*admin)->sendServiceReleased);
     celixThreadMutex_destroy(&(*admin)->sendServicesLock);
     celixThreadMutex_destroy(&(*admin)->exportedServicesLock);
+    hashMap_destroy((*admin)->exportIndex, false, false);
+    celixThreadCondition_destroy(&(*admin)->exportReleased);
+    celixThreadMutex_destroy(&(*admin)->exportIndexLock);
     celixThreadMutex_destroy(&(*admin)->importedServicesLock);
 
     free(*admin);
@@ -136,8 +144,36 @@ celix_status_t remoteServiceAdmin_stop(remote_service_admin_pt admin) {
     hashMapIterator_destroy(iter);
     celixThreadMutex_unlock(&admin->exportedServicesLock);
 
+    // requests no longer reach the exports, the ones still running finish before the endpoints go
+    array_list_pt exportIndexEntries = NULL;
+
+    arrayList_create(&exportIndexEntries);
+    celixThreadMutex_lock(&admin->exportIndexLock);
+
+    iter = hashMapIterator_create(admin->exportIndex);
+    while (hashMapIterator_hasNext(iter)) {
+        arrayList_add(exportIndexEntries, hashMapIterator_nextValue(iter));
+    }
+    hashMapIterator_destroy(iter);
+
+    hashMap_clear(admin->exportIndex, false, false);
+
     int i;
 
+    for (i = 0; i < arrayList_size(exportIndexEntries); i++) {
+        export_index_entry_pt entry = arrayList_get(exportIndexEntries, i);
+
+        while (entry->refCount > 0) {
+            celixThreadCondition_wait(&admin->exportReleased, &admin->exportIndexLock);
+        }
+
+        free(entry);
+    }
+
+    celixThreadMutex_unlock(&admin->exportIndexLock);
+    arrayList_destroy(exportIndexEntries);
+
+
     for (i = 0; i < arrayList_size(exportRegistrationList); i++) {
         export_registration_pt export = arrayList_get(exportRegistrationList, i);
         exportRegistration_stopTracking(export);
@@ -195,49 +231,71 @@ static celix_status_t remoteServiceAdmin_receive(void* handle, char* data, char*
     celix_status_t status = CELIX_ILLEGAL_ARGUMENT;
     remote_service_admin_pt admin = (remote_service_admin_pt) handle;
 
-    //celixThreadMutex_lock(&admin->exportedServicesLock);
     json_error_t jsonError;
-    json_t* root;
+    json_t* root = NULL;
 
-    root = json_loads(data, 0, &jsonError);
+    long serviceId = -1;
+    char* request = NULL;
+    char* jsonRequest = NULL;
 
-    if (root) {
-        int serviceId = -1;
-        char* request = NULL;
-        json_t* json_request = NULL;
+    if (strncmp(data, RSA_INAETICS_ENVELOPE_MAGIC, strlen(RSA_INAETICS_ENVELOPE_MAGIC)) == 0) {
+        unsigned int flags = 0;
 
-        json_unpack(root, "{s:i, s:o}", "service.id", &serviceId, "request", &json_request);
-        request = json_dumps(json_request, 0);
+        // the payload is handed to the endpoint in place
+        if (remoteServiceAdmin_parseEnvelope(data, &serviceId, &flags, &request) != CELIX_SUCCESS) {
+            printf("RSA: received malformed request envelope\n");
+        }
+    } else {
+        root = json_loads(data, 0, &jsonError);
 
-        hash_map_iterator_pt iter = hashMapIterator_create(admin->exportedServices);
-        while (hashMapIterator_hasNext(iter)) {
-            hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
-            array_list_pt exports = hashMapEntry_getValue(entry);
+        if (root) {
+            int jsonServiceId = -1;
+            json_t* json_request = NULL;
 
-            int expIt = 0;
-            for (expIt = 0; (expIt < arrayList_size(exports)) && (status != CELIX_SUCCESS); expIt++) {
-                export_registration_pt export = arrayList_get(exports, expIt);
+            json_unpack(root, "{s:i, s:o}", "service.id", &jsonServiceId, "request", &json_request);
+            jsonRequest = json_dumps(json_request, 0);
 
-                if (serviceId == export->endpointDescription->serviceId) {
-                    if (export->endpoint != NULL) {
-                        export->endpoint->handleRequest(export->endpoint->endpoint, request, response);
-                    } else {
-                        printf("RSA: endpoint for serviceId %d not available\n", serviceId);
-                        status = CELIX_SERVICE_EXCEPTION;
-                    }
-                    status = CELIX_SUCCESS;
-                }
-            }
+            serviceId = jsonServiceId;
+            request = jsonRequest;
+        }
+    }
+
+    if (request != NULL) {
+        celixThreadMutex_lock(&admin->exportIndexLock);
+
+        export_index_entry_pt entry = hashMap_get(admin->exportIndex, (void*) serviceId);
 
+        if (entry != NULL) {
+            entry->refCount++;
         }
 
-        free(request);
-        json_decref(root);
+        celixThreadMutex_unlock(&admin->exportIndexLock);
 
-        //celixThreadMutex_unlock(&admin->exportedServicesLock);
+        // the reference keeps the export registered while its endpoint handles the request
+        if (entry != NULL) {
+            export_registration_pt export = entry->registration;
 
-        hashMapIterator_destroy(iter);
+            if (export->endpoint != NULL) {
+                export->endpoint->handleRequest(export->endpoint->endpoint, request, response);
+                status = CELIX_SUCCESS;
+            } else {
+                printf("RSA: endpoint for serviceId %ld not available\n", serviceId);
+                status = CELIX_SERVICE_EXCEPTION;
+            }
+
+            celixThreadMutex_lock(&admin->exportIndexLock);
+            if (--entry->refCount == 0) {
+                celixThreadCondition_broadcast(&admin->exportReleased);
+            }
+            celixThreadMutex_unlock(&admin->exportIndexLock);
+        }
+    }
+
+    free(jsonRequest);
+    if (root != NULL) {
+        json_decref(root);
     }
+
     return status;
 }
 
@@ -615,12 +673,33 @@ celix_status_t remoteServiceAdmin_exportService(remote_service_admin_pt admin, c
                 }
 
                 if (status == CELIX_SUCCESS) {
+                    int regIt;
+
                     celixThreadMutex_lock(&admin->exportedServicesLock);
 
                     hashMap_put(admin->exportedServices, reference, *registrations);
 
                     celixThreadMutex_unlock(&admin->exportedServicesLock);
 
+                    // requests address the first registration of a service, as the linear search used to do
+                    celixThreadMutex_lock(&admin->exportIndexLock);
+
+                    for (regIt = 0; regIt < arrayList_size(*registrations); regIt++) {
+                        export_registration_pt export = arrayList_get(*registrations, regIt);
+                        void* key = (void*) export->endpointDescription->serviceId;
+
+                        if (!hashMap_containsKey(admin->exportIndex, key)) {
+                            export_index_entry_pt entry = calloc(1, sizeof(*entry));
+
+                            if (entry != NULL) {
+                                entry->registration = export;
+                                hashMap_put(admin->exportIndex, key, entry);
+                            }
+                        }
+                    }
+
+                    celixThreadMutex_unlock(&admin->exportIndexLock);
+
                     if (properties == NULL) {
                         properties = properties_create();
 
@@ -689,6 +768,24 @@ celix_status_t remoteServiceAdmin_removeExportedService(export_registration_pt r
 
     celixThreadMutex_unlock(&admin->exportedServicesLock);
 
+    celixThreadMutex_lock(&admin->exportIndexLock);
+
+    void* key = (void*) registration->endpointDescription->serviceId;
+    export_index_entry_pt entry = hashMap_get(admin->exportIndex, key);
+
+    if (entry != NULL && entry->registration == registration) {
+        hashMap_remove(admin->exportIndex, key);
+
+        // new requests no longer find the registration, wait for the ones it is still handling
+        while (entry->refCount > 0) {
+            celixThreadCondition_wait(&admin->exportReleased, &admin->exportIndexLock);
+        }
+
+        free(entry);
+    }
+
+    celixThreadMutex_unlock(&admin->exportIndexLock);
+
     return status;
 }
 
@@ -731,6 +828,7 @@ celix_status_t remoteServiceAdmin_installEndpoint(remote_service_admin_pt admin,
     properties_set(endpointProperties, (char*) OSGI_RSA_ENDPOINT_ID, endpoint_uuid);
     properties_set(endpointProperties, (char*) OSGI_RSA_SERVICE_IMPORTED, "true");
     properties_set(endpointProperties, (char*) OSGI_RSA_SERVICE_IMPORTED_CONFIGS, (char*) CONFIGURATION_TYPE);
+    properties_set(endpointProperties, RSA_INAETICS_ENVELOPE_KEY, RSA_INAETICS_ENVELOPE_BINARY);
 
     endpoint_description_pt endpointDescription = NULL;
     remoteServiceAdmin_createEndpointDescription(admin, reference, endpointProperties, interface, &endpointDescription);
@@ -921,36 +1019,65 @@ celix_status_t remoteServiceAdmin_send(remote_service_admin_pt admin, endpoint_d
     if (wireId == NULL) {
         printf("RSA: send called w/ proper endpoint_description: wireId missing.\n");
     } else {
-        wiring_send_service_pt wiringSendService = NULL;
+        send_service_entry_pt entry = NULL;
 
         status = celixThreadMutex_lock(&admin->sendServicesLock);
 
         if (status == CELIX_SUCCESS) {
-            wiringSendService = hashMap_get(admin->sendServices, wireId);
+            entry = hashMap_get(admin->sendServices, wireId);
+
+            if (entry != NULL) {
+                entry->refCount++;
+            }
+
+            celixThreadMutex_unlock(&admin->sendServicesLock);
+        }
 
-            if (wiringSendService == NULL) {
-                printf("RSA: No SendService w/ wireId %s found.\n", wireId);
-                status = CELIX_ILLEGAL_ARGUMENT;
+        if (status == CELIX_SUCCESS && entry == NULL) {
+            printf("RSA: No SendService w/ wireId %s found.\n", wireId);
+            status = CELIX_ILLEGAL_ARGUMENT;
+        } else if (status == CELIX_SUCCESS) {
+            wiring_send_service_pt wiringSendService = entry->service;
+            char* envelope = properties_get(endpointDescription->properties, RSA_INAETICS_ENVELOPE_KEY);
+            long serviceId = endpointDescription->serviceId;
+            char *data = NULL;
+            size_t length = 0;
+
+            // exporters that do not announce the envelope only understand the JSON one
+            if (envelope != NULL && strcmp(envelope, RSA_INAETICS_ENVELOPE_BINARY) == 0) {
+                status = remoteServiceAdmin_createEnvelope(serviceId, 0, request, &data, &length);
             } else {
                 json_t *root;
                 json_t *json_request;
                 json_error_t jsonError;
 
                 json_request = json_loads(request, 0, &jsonError);
-                long serviceId = endpointDescription->serviceId;
                 root = json_pack("{s:i, s:o}", "service.id", serviceId, "request", json_request);
-                char *json_data = json_dumps(root, 0);
-
-                status = wiringSendService->send(wiringSendService, json_data, reply, replyStatus);
+                data = json_dumps(root, 0);
 
-                if (status != CELIX_SUCCESS || *reply == NULL) {
-                    printf("RSA: wireSendService->send of wireId %s return no success\n", wireId);
+                if (data == NULL) {
+                    status = CELIX_ENOMEM;
+                } else {
+                    length = strlen(data);
                 }
 
-
-                free(json_data);
                 json_decref(root);
             }
+
+            if (status == CELIX_SUCCESS) {
+                status = wiringSendService->sendSized(wiringSendService, data, length, reply, replyStatus);
+            }
+
+            if (status != CELIX_SUCCESS || *reply == NULL) {
+                printf("RSA: wireSendService->send of wireId %s return no success\n", wireId);
+            }
+
+            free(data);
+
+            celixThreadMutex_lock(&admin->sendServicesLock);
+            if (--entry->refCount == 0) {
+                celixThreadCondition_broadcast(&admin->sendServiceReleased);
+            }
             celixThreadMutex_unlock(&admin->sendServicesLock);
         }
     }
@@ -1017,8 +1144,20 @@ static celix_status_t remoteServiceAdmin_sendServiceAdded(void * handle, service
     status = celixThreadMutex_lock(&admin->sendServicesLock);
 
     if (status == CELIX_SUCCESS) {
-        hashMap_put(admin->sendServices, wireId, wiringSendService);
-        status = celixThreadMutex_unlock(&admin->sendServicesLock);
+        if (hashMap_containsKey(admin->sendServices, wireId)) {
+            printf("RSA: SendService for wireId %s already present, ignoring the new one\n", wireId);
+        } else {
+            send_service_entry_pt entry = calloc(1, sizeof(*entry));
+
+            if (entry == NULL) {
+                status = CELIX_ENOMEM;
+            } else {
+                entry->service = wiringSendService;
+                entry->refCount = 0;
+                hashMap_put(admin->sendServices, wireId, entry);
+            }
+        }
+        celixThreadMutex_unlock(&admin->sendServicesLock);
     }
 
     return status;
@@ -1041,7 +1180,18 @@ static celix_status_t remoteServiceAdmin_sendServiceRemoved(void * handle, servi
     status = celixThreadMutex_lock(&admin->sendServicesLock);
 
     if (status == CELIX_SUCCESS) {
-        hashMap_remove(admin->sendServices, wireId);
+        send_service_entry_pt entry = hashMap_get(admin->sendServices, wireId);
+
+        if (entry != NULL && entry->service == wiringSendService) {
+            hashMap_remove(admin->sendServices, wireId);
+
+            // the service is ungotten after this callback returns, so wait for the calls still using it
+            while (entry->refCount > 0) {
+                celixThreadCondition_wait(&admin->sendServiceReleased, &admin->sendServicesLock);
+            }
+
+            free(entry);
+        }
         status = celixThreadMutex_unlock(&admin->sendServicesLock);
     }
 
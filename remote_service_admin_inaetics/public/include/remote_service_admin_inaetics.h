@@ -6,6 +6,7 @@
 #define REMOTE_SERVICE_ADMIN_INAETICS_H_
 
 #include "celix_errno.h"
+#include "wiring_stream.h"
 
 static const char * const INAETICS_WIRING_RECEIVE_SERVICE = "wiring_receive";
 
@@ -13,6 +14,12 @@ struct wiring_receive_service {
 	char* wireId;
 	void* handle;
 	celix_status_t (*receive)(void* handle, char* data, char** response);
+	/*
+	 * optional, may be NULL. Receives a streamed request in bounded chunks from request and writes the
+	 * response to response; nothing written means no response. Streamed requests for receivers
+	 * without it are collected and handed to receive.
+	 */
+	celix_status_t (*receiveStream)(void* handle, wiring_stream_reader_pt request, wiring_stream_writer_pt response);
 };
 
 typedef struct wiring_receive_service *wiring_receive_service_pt;
@@ -0,0 +1,99 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+/*
+ * Round trips of the request envelope (see remote_service_admin_envelope.h), and the malformed
+ * envelopes the receiving remote service admin has to reject.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "remote_service_admin_envelope.h"
+
+#define WIRING_TEST_TAG             "RSA_ENVELOPE_TEST"
+
+#include "wiring_test.h"
+
+static void envelopeTest_roundTrip(void) {
+    char big[4096];
+    const char* payloads[] = { "", "{\"m\":\"add(DD)D\",\"a\":[1.0,2.0]}", big };
+    long serviceIds[] = { 0, 42, 0x7FFFFFFFL, -1 };
+    unsigned int flags[] = { 0, 1, 0xFFFFFFFFU };
+    unsigned int p, s, f;
+
+    memset(big, 'b', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+
+    for (p = 0; p < sizeof(payloads) / sizeof(payloads[0]); p++) {
+        for (s = 0; s < sizeof(serviceIds) / sizeof(serviceIds[0]); s++) {
+            for (f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+                char* data = NULL;
+                size_t length = 0;
+                long serviceId = 0;
+                unsigned int parsedFlags = 0;
+                char* payload = NULL;
+
+                CHECK(remoteServiceAdmin_createEnvelope(serviceIds[s], flags[f], payloads[p], &data, &length) == CELIX_SUCCESS);
+                CHECK(data != NULL && length == strlen(data));
+                CHECK(length == RSA_INAETICS_ENVELOPE_HEADER_SIZE + strlen(payloads[p]));
+                CHECK(strncmp(data, RSA_INAETICS_ENVELOPE_MAGIC, strlen(RSA_INAETICS_ENVELOPE_MAGIC)) == 0);
+
+                CHECK(remoteServiceAdmin_parseEnvelope(data, &serviceId, &parsedFlags, &payload) == CELIX_SUCCESS);
+                CHECK(serviceId == serviceIds[s]);
+                CHECK(parsedFlags == flags[f]);
+
+                // the payload is not copied
+                CHECK(payload == data + RSA_INAETICS_ENVELOPE_HEADER_SIZE);
+                CHECK(payload != NULL && strcmp(payload, payloads[p]) == 0);
+
+                free(data);
+            }
+        }
+    }
+}
+
+static void envelopeTest_header(void) {
+    char* data = NULL;
+    size_t length = 0;
+
+    CHECK(remoteServiceAdmin_createEnvelope(26, 1, "{}", &data, &length) == CELIX_SUCCESS);
+    CHECK(data != NULL && strcmp(data, RSA_INAETICS_ENVELOPE_MAGIC "000000000000001a" "00000001" "00000002" "{}") == 0);
+    CHECK(length == RSA_INAETICS_ENVELOPE_HEADER_SIZE + 2);
+
+    free(data);
+}
+
+static void envelopeTest_malformed(void) {
+    char* envelopes[] = {
+        "",
+        "RSB1",
+        "RSB1" "000000000000001a" "00000001" "0000000",
+        "RSB1" "00000000000000zz" "00000001" "00000002" "{}",
+        "RSB1" "000000000000001a" "0000000g" "00000002" "{}",
+        "RSB1" "000000000000001a" "00000001" "0000000x" "{}",
+        "RSB1" "             -1a" "00000001" "00000002" "{}",
+        "RSB1" "000000000000001a" "00000001" "00000003" "{}",
+        "RSB1" "000000000000001a" "00000001" "00000001" "{}",
+        "RSB1" "000000000000001a" "00000001" "ffffffff" "{}",
+        NULL };
+    int i;
+
+    for (i = 0; envelopes[i] != NULL; i++) {
+        long serviceId = 0;
+        unsigned int flags = 0;
+        char* payload = NULL;
+
+        CHECK_CASE(remoteServiceAdmin_parseEnvelope(envelopes[i], &serviceId, &flags, &payload) == CELIX_ILLEGAL_ARGUMENT, i);
+        CHECK_CASE(payload == NULL, i);
+    }
+}
+
+int main(int argc, char** argv) {
+    envelopeTest_roundTrip();
+    envelopeTest_header();
+    envelopeTest_malformed();
+
+    return wiringTest_result();
+}
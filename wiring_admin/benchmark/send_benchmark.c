@@ -0,0 +1,185 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+/*
+ * Measures the throughput of the HTTP send path: requests are uploaded the way the wiring admin
+ * does it (pooled keep-alive curl handle, request passed as CURLOPT_POSTFIELDS, reply collected in
+ * a wiring_buffer) to a local civetweb server that echoes them back. Compression is left out.
+ *
+ * usage: send_benchmark [port] [megabytes per payload size]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <curl/curl.h>
+
+#include "civetweb.h"
+#include "wiring_buffer.h"
+
+#define TAG                         "SEND_BENCHMARK"
+
+#define DEFAULT_BENCHMARK_PORT      "6799"
+#define DEFAULT_BENCHMARK_MEGABYTES 256
+#define MIN_ITERATIONS              16
+#define MAX_ITERATIONS              100000
+
+static const char *echo_response_headers = "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "Content-Length: %lu\r\n"
+        "\r\n";
+
+static const size_t payload_sizes[] = { 64, 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024 };
+
+static int sendBenchmark_echo(struct mg_connection *conn) {
+    const struct mg_request_info *request_info = mg_get_request_info(conn);
+    wiring_buffer_pt buffer = NULL;
+    size_t capacity = (request_info->content_length > 0) ? (size_t) request_info->content_length : 0;
+
+    if (wiringBuffer_create(capacity, &buffer) == CELIX_SUCCESS) {
+        char chunk[16 * 1024];
+        int bytes = 0;
+
+        while ((bytes = mg_read(conn, chunk, sizeof(chunk))) > 0) {
+            wiringBuffer_append(buffer, chunk, bytes);
+        }
+
+        mg_printf(conn, echo_response_headers, (unsigned long) buffer->size);
+        mg_write(conn, buffer->data, buffer->size);
+
+        wiringBuffer_destroy(buffer);
+    }
+
+    return 1;
+}
+
+static celix_status_t sendBenchmark_send(CURL* curl, const char* request, size_t requestLength, wiring_buffer_pt replyBuffer) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    long http_code = 0;
+    CURLcode res;
+
+    wiringBuffer_reset(replyBuffer);
+
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) requestLength);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request);
+    res = curl_easy_perform(curl);
+
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+    if (res != CURLE_OK || http_code != 200 || replyBuffer->status != CELIX_SUCCESS || replyBuffer->size != requestLength) {
+        status = CELIX_ILLEGAL_STATE;
+    }
+
+    return status;
+}
+
+int main(int argc, char** argv) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    const char* port = (argc > 1) ? argv[1] : DEFAULT_BENCHMARK_PORT;
+    long megabytes = (argc > 2) ? strtol(argv[2], NULL, 10) : DEFAULT_BENCHMARK_MEGABYTES;
+    char url[64];
+    unsigned int i;
+
+    struct mg_callbacks callbacks;
+    struct mg_context *ctx = NULL;
+    const char *options[] = {
+            "listening_ports", port,
+            "num_threads", "2",
+            "enable_keep_alive", "yes",
+            NULL };
+
+    CURL* curl = NULL;
+    wiring_buffer_pt replyBuffer = NULL;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+
+    memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.begin_request = sendBenchmark_echo;
+
+    ctx = mg_start(&callbacks, NULL, options);
+
+    if (ctx == NULL) {
+        printf("%s: cannot listen on port %s\n", TAG, port);
+        status = CELIX_ILLEGAL_STATE;
+    } else {
+        snprintf(url, sizeof(url), "http://127.0.0.1:%s/benchmark", port);
+
+        curl = curl_easy_init();
+        status = (curl != NULL) ? wiringBuffer_create(0, &replyBuffer) : CELIX_ILLEGAL_STATE;
+    }
+
+    if (status == CELIX_SUCCESS) {
+        // same options as a pooled handle of the wiring admin
+        curl_easy_setopt(curl, CURLOPT_URL, url);
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 2L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+        wiringBuffer_attachToCurl(replyBuffer, curl);
+
+        printf("%12s %10s %14s %12s\n", "payload (B)", "requests", "requests/s", "MB/s");
+
+        for (i = 0; status == CELIX_SUCCESS && i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++) {
+            size_t size = payload_sizes[i];
+            long iterations = (megabytes * 1024 * 1024) / (long) size;
+            char* request = malloc(size + 1);
+            struct timespec start, end;
+            double seconds = 0;
+            long n;
+
+            if (iterations < MIN_ITERATIONS) {
+                iterations = MIN_ITERATIONS;
+            } else if (iterations > MAX_ITERATIONS) {
+                iterations = MAX_ITERATIONS;
+            }
+
+            if (request == NULL) {
+                status = CELIX_ENOMEM;
+                break;
+            }
+
+            memset(request, 'x', size);
+            request[size] = '\0';
+
+            // warm up the connection so it is not part of the measurement
+            status = sendBenchmark_send(curl, request, size, replyBuffer);
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            for (n = 0; status == CELIX_SUCCESS && n < iterations; n++) {
+                status = sendBenchmark_send(curl, request, size, replyBuffer);
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            if (status == CELIX_SUCCESS) {
+                seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+                printf("%12zu %10ld %14.0f %12.1f\n", size, iterations, iterations / seconds, (iterations * (double) size) / (1024 * 1024) / seconds);
+            } else {
+                printf("%s: sending %zu bytes failed\n", TAG, size);
+            }
+
+            free(request);
+        }
+    }
+
+    wiringBuffer_destroy(replyBuffer);
+
+    if (curl != NULL) {
+        curl_easy_cleanup(curl);
+    }
+
+    if (ctx != NULL) {
+        mg_stop(ctx);
+    }
+
+    curl_global_cleanup();
+
+    return (status == CELIX_SUCCESS) ? 0 : 1;
+}
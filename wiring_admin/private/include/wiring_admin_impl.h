@@ -14,12 +14,74 @@
 #include "service_registration.h"
 #include "celix_threads.h"
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <curl/curl.h>
+
 #include "wiring_admin.h"
+#include "remote_service_admin_inaetics.h"
+#include "wiring_receive_registry.h"
 
 #define MAX_URL_LENGTH 			128
+#define MAX_WIRE_ID_LENGTH		64
+
+// maximum number of idle curl handles kept per wire
+#define MAX_POOLED_CURL_HANDLES	8
+
+// upper bound (in ms) the async event loop sleeps when no transfer makes progress
+#define WIRING_ADMIN_ASYNC_POLL_TIMEOUT	1000
+
+// threads handing asynchronous requests of wires exported by this framework to their receivers
+#define WIRING_ADMIN_LOCAL_ASYNC_THREADS	2
 
 //#define WIRING_ENDPOINT_DESCRIPTION_CONFIG_VALUE		"inaetics.wiring.http"
 
+// framework properties tuning the embedded webserver
+#define WIRING_ADMIN_NUM_THREADS				"WIRING_ADMIN_NUM_THREADS"
+#define WIRING_ADMIN_KEEP_ALIVE					"WIRING_ADMIN_KEEP_ALIVE"
+#define WIRING_ADMIN_REQUEST_TIMEOUT_MS			"WIRING_ADMIN_REQUEST_TIMEOUT_MS"
+#define WIRING_ADMIN_MAX_REQUEST_SIZE			"WIRING_ADMIN_MAX_REQUEST_SIZE"
+
+// worker threads started per online CPU when WIRING_ADMIN_NUM_THREADS is not set
+#define DEFAULT_WA_THREADS_PER_CPU				2
+#define DEFAULT_WA_KEEP_ALIVE					"yes"
+#define DEFAULT_WA_REQUEST_TIMEOUT_MS			"30000"
+
+/*
+ * Exported wires announce the payload compression they accept in their endpoint description.
+ * Requests and replies below the threshold (in bytes) are always sent as they are.
+ */
+#define WIRING_ADMIN_COMPRESSION				"WIRING_ADMIN_COMPRESSION"
+#define WIRING_ADMIN_COMPRESSION_THRESHOLD		"WIRING_ADMIN_COMPRESSION_THRESHOLD"
+#define WIRING_ADMIN_COMPRESSION_DEFLATE		"deflate"
+#define WIRING_ADMIN_COMPRESSION_NONE			"none"
+
+#define DEFAULT_WA_COMPRESSION					WIRING_ADMIN_COMPRESSION_DEFLATE
+#define DEFAULT_WA_COMPRESSION_THRESHOLD		1024
+// bytes a compressed request may inflate to when WIRING_ADMIN_MAX_REQUEST_SIZE is not set
+#define DEFAULT_WA_MAX_INFLATED_SIZE			(64 * 1024 * 1024)
+
+/*
+ * Requests are not tagged with an id: HTTP/1.1 answers the requests of a connection in order and a
+ * pooled connection only carries one request at a time, so a response always belongs to the request
+ * sent before it. Concurrent requests on a wire use separate connections; replies out of order over
+ * a single connection are what the TCP wiring admin offers.
+ */
+
+// query string marking a request whose body is a batch of requests (see wiring_batch.h)
+#define WIRING_ADMIN_BATCH_QUERY					"batch"
+// query string of one-way requests, which are answered with 204 before they are dispatched
+#define WIRING_ADMIN_ONEWAY_QUERY					"oneway"
+
+/*
+ * Streamed requests are uploaded chunked on a connection of their own. The reply is sent chunked as
+ * well, followed by a trailer carrying the status returned by the receiver.
+ */
+#define WIRING_ADMIN_STREAM_QUERY					"stream"
+#define WIRING_ADMIN_STREAM_STATUS_HEADER			"X-Wiring-Stream-Status"
+// seconds a streamed transfer may stall before the sender gives up
+#define WIRING_ADMIN_STREAM_STALL_TIMEOUT			30
+
 #define WIRING_ADMIN_PROPERTIES_CONFIG_VALUE		"inaetics.wiring.http"
 #define WIRING_ADMIN_PROPERTIES_SECURE_VALUE 		"no"
 
@@ -36,10 +98,29 @@ struct wiring_admin {
 	hash_map_pt wiringSendServices; //key=wiring_endpoint_desc,  value=services
 	hash_map_pt wiringSendRegistrations; //key=wiring_endpoint_desc,  value=serviceRegistrations
 
-	hash_map_pt wiringReceiveServices; //key=wiring_endpoint_desc,  value=services
-	hash_map_pt wiringReceiveTracker; //key=wiring_endpoint_desc,  value=tracker
+	wiring_receive_registry_pt receiveRegistry;
+
+	celix_thread_mutex_t curlHandlePoolsLock;
+	hash_map_pt curlHandlePools; //key=url, value=curl_handle_pool
+
+	CURLM* asyncMulti;
+	celix_thread_t asyncThread;
+	volatile bool asyncRunning;
+	int asyncWakeupPipe[2];
+	celix_thread_mutex_t asyncQueueLock;
+	array_list_pt asyncQueue; //requests not yet handed to the event loop, guarded by asyncQueueLock
+	array_list_pt asyncActive; //requests owned by the event loop thread
+
+	celix_thread_cond_t localAsyncQueued;
+	array_list_pt localAsyncQueue; //requests for local wires, guarded by asyncQueueLock
+	celix_thread_t localAsyncWorkers[WIRING_ADMIN_LOCAL_ASYNC_THREADS];
+	int localAsyncWorkerCount;
 
 	char url[MAX_URL_LENGTH];
+	uint64_t maxRequestSize; //0 means unlimited
+
+	bool compression;
+	size_t compressionThreshold;
 
 	struct mg_context *ctx;
 };
@@ -51,6 +132,11 @@ typedef struct wiring_proxy_registration {
 
 }* wiring_proxy_registration_pt;
 
+// guarded by curlHandlePoolsLock, so a pool can be dropped together with its wire
+typedef struct curl_handle_pool {
+	array_list_pt idleHandles;
+}* curl_handle_pool_pt;
+
 celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *admin);
 celix_status_t wiringAdmin_destroy(wiring_admin_pt* admin);
 celix_status_t wiringAdmin_stop(wiring_admin_pt admin);
@@ -9,6 +9,7 @@
 #include "service_registration.h"
 
 #include "wiring_admin_impl.h"
+#include "wiring_common_utils.h"
 
 struct activator {
 	bundle_context_pt context;
@@ -24,6 +25,10 @@ celix_status_t bundleActivator_create(bundle_context_pt context, void **userData
 	activator = calloc(1, sizeof(*activator));
 	if (!activator) {
 		status = CELIX_ENOMEM;
+	} else if (curl_global_init(CURL_GLOBAL_ALL) != 0) {
+		// done before the admin starts its threads; libcurl is shared with other bundles, so no cleanup on stop
+		free(activator);
+		status = CELIX_BUNDLE_EXCEPTION;
 	} else {
 		activator->context = context;
 		activator->admin = NULL;
@@ -56,22 +61,7 @@ celix_status_t bundleActivator_start(void * userData, bundle_context_pt context)
 			activator->wiringAdminService->importWiringEndpoint = wiringAdmin_importWiringEndpoint;
 			activator->wiringAdminService->removeImportedWiringEndpoint = wiringAdmin_removeImportedWiringEndpoint;
 
-			char *uuid = NULL;
-			status = bundleContext_getProperty(activator->context, (char *) OSGI_FRAMEWORK_FRAMEWORK_UUID, &uuid);
-
-			if (status != CELIX_SUCCESS) {
-				printf("%s: no framework UUID defined?!\n", TAG);
-			} else {
-				size_t len = 14 + strlen(OSGI_FRAMEWORK_OBJECTCLASS) + strlen(OSGI_RSA_ENDPOINT_FRAMEWORK_UUID) + strlen(uuid);
-				char scope[len + 1];
-
-				snprintf(scope, len, "(%s=%s)", OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, uuid);
-
-				properties_pt props = properties_create();
-				properties_set(props, (char *) INAETICS_WIRING_ADMIN_SCOPE, scope);
-
-				status = bundleContext_registerService(context, (char*) INAETICS_WIRING_ADMIN, activator->wiringAdminService, props, &activator->registration);
-			}
+			status = wiring_registerAdminService(context, TAG, activator->wiringAdminService, &activator->registration);
 		}
 	}
 
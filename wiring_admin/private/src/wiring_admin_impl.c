@@ -9,10 +9,12 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <strings.h>
+#include <fcntl.h>
 #include <uuid/uuid.h>
+#include <zlib.h>
 
 #include <properties.h>
-#include <service_tracker.h>
 #include "curl/curl.h"
 
 #include "remote_service_admin.h"
@@ -21,40 +23,143 @@
 #include "wiring_admin.h"
 #include "wiring_admin_impl.h"
 #include "wiring_common_utils.h"
+#include "wiring_buffer.h"
+#include "wiring_batch.h"
 
 #include "civetweb.h"
 
 // defines how often the webserver is restarted (with an increased port number)
 #define MAX_NUMBER_OF_RESTARTS 	5
 
-struct post {
-    const char *readptr;
-    int size;
+// output is inflated in steps of this size
+#define INFLATE_CHUNK_SIZE		16384
+
+#define CONTENT_ENCODING_DEFLATE_HEADER		"Content-Encoding: " WIRING_ADMIN_COMPRESSION_DEFLATE
+
+// header lists are only read by curl, so requests share these instead of building their own
+static char deflate_header[] = CONTENT_ENCODING_DEFLATE_HEADER;
+static struct curl_slist deflate_request_headers = { deflate_header, NULL };
+
+static char connection_close_header[] = "Connection: close";
+static char chunked_header[] = "Transfer-Encoding: chunked";
+static struct curl_slist stream_request_close_header = { connection_close_header, NULL };
+static struct curl_slist stream_request_headers = { chunked_header, &stream_request_close_header };
+
+// a streamed request being sent, curl pulls the request from reader and pushes the reply to writer
+struct stream_transfer {
+    CURL* curl;
+    wiring_stream_reader_pt reader;
+    wiring_stream_writer_pt writer;
+    celix_status_t status;
+    int receiveStatus; // trailer of the streamed reply, if any
 };
 
-struct get {
-    char *writeptr;
-    int size;
+// a streamed request being received by the webserver
+struct stream_connection {
+    struct mg_connection *conn;
+    bool headersSent;
+    bool ended;
 };
 
+// what a receiver of a local wire wrote to the reply of a streamed request
+struct stream_counter {
+    wiring_stream_writer_pt writer;
+    size_t written;
+};
+
+typedef struct wiring_async_request {
+    wiring_admin_pt admin;
+    char* url;
+    char* request; // handed to curl as is, it has to live until the transfer is done
+    size_t requestLength;
+    bool deflated; // request holds the compressed payload
+    CURL* curl;
+    wiring_buffer_pt replyBuffer;
+    wiring_send_callback_pt callback;
+    void* userdata;
+    char* wireId; // only set for wires exported by this framework, which are dispatched without HTTP
+}* wiring_async_request_pt;
+
+// every response is explicitly framed, so the connection can be kept alive for the next request
+// the trailing %s is the content encoding header of a compressed reply
 static const char *data_response_headers = "HTTP/1.1 200 OK\r\n"
         "Cache: no-cache\r\n"
         "Content-Type: application/json\r\n"
+        "Content-Length: %lu\r\n"
+        "%s"
+        "\r\n";
+
+// streamed replies are sent chunked, the status of the receiver follows in the trailer
+static const char *stream_response_headers = "HTTP/1.1 200 OK\r\n"
+        "Cache: no-cache\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Trailer: " WIRING_ADMIN_STREAM_STATUS_HEADER "\r\n"
+        "\r\n";
+
+static const char *no_content_response_headers = "HTTP/1.1 204 No Content\r\n"
+        "\r\n";
+
+static const char *too_large_response_headers = "HTTP/1.1 413 Request Entity Too Large\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n";
+
+static const char *not_found_response_headers = "HTTP/1.1 404 Not Found\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n";
+
+static const char *bad_request_response_headers = "HTTP/1.1 400 Bad Request\r\n"
+        "Content-Length: 0\r\n"
         "\r\n";
 
-static const char *no_content_response_headers = "HTTP/1.1 204 OK\r\n";
+static const char *internal_error_response_headers = "HTTP/1.1 500 Internal Server Error\r\n"
+        "Content-Length: 0\r\n"
+        "\r\n";
 
 static int wiringAdmin_callback(struct mg_connection *conn);
 
-static size_t wiringAdmin_HTTPReqReadCallback(void *ptr, size_t size, size_t nmemb, void *userp);
-static size_t wiringAdmin_HTTPReqWrite(void *contents, size_t size, size_t nmemb, void *userp);
+static size_t wiringAdmin_HTTPStreamHeaderCallback(char *buffer, size_t size, size_t nitems, void *userp);
+static size_t wiringAdmin_HTTPStreamReadCallback(void *ptr, size_t size, size_t nmemb, void *userp);
+static size_t wiringAdmin_HTTPStreamWriteCallback(void *contents, size_t size, size_t nmemb, void *userp);
+static bool wiringAdmin_getHeaderValue(const char* buffer, size_t length, const char* name, char* value, size_t valueSize);
 
-static celix_status_t wiringAdmin_wiringReceiveAdding(void * handle, service_reference_pt reference, void **service);
-static celix_status_t wiringAdmin_wiringReceiveAdded(void * handle, service_reference_pt reference, void * service);
-static celix_status_t wiringAdmin_wiringReceiveModified(void * handle, service_reference_pt reference, void * service);
-static celix_status_t wiringAdmin_wiringReceiveRemoved(void * handle, service_reference_pt reference, void * service);
+static celix_status_t wiringAdmin_readBody(wiring_admin_pt admin, struct mg_connection *conn, int64_t contentLength, char** data, size_t* length);
+static bool wiringAdmin_handleStream(wiring_admin_pt admin, struct mg_connection *conn, const char* wireId);
+static celix_status_t wiringAdmin_streamRead(void* handle, char* buffer, size_t size, size_t* length);
+static celix_status_t wiringAdmin_streamWrite(void* handle, const char* data, size_t length);
+static void wiringAdmin_streamDrain(struct stream_connection* stream);
 
 static celix_status_t wiringAdmin_send(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendSized(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendRequest(wiring_send_service_pt sendService, char* url, const char *request, size_t requestLength, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendBatch(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses);
+
+static celix_status_t wiringAdmin_sendAsync(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata);
+static celix_status_t wiringAdmin_sendOneway(wiring_send_service_pt sendService, char *request);
+static celix_status_t wiringAdmin_sendStream(wiring_send_service_pt sendService, wiring_stream_reader_pt request, wiring_stream_writer_pt reply, int* replyStatus);
+static celix_status_t wiringAdmin_queueRequest(wiring_admin_pt admin, char* url, char *request, bool compress, wiring_send_callback_pt callback, void* userdata);
+
+static bool wiringAdmin_useCompression(wiring_send_service_pt sendService);
+static celix_status_t wiringAdmin_deflate(const char* data, size_t length, char** deflated, size_t* deflatedLength);
+static celix_status_t wiringAdmin_inflate(wiring_admin_pt admin, const char* data, size_t length, char** inflated, size_t* inflatedLength);
+
+static celix_status_t wiringAdmin_sendLocal(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendSizedLocal(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendAsyncLocal(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata);
+static celix_status_t wiringAdmin_sendBatchLocal(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses);
+static celix_status_t wiringAdmin_sendOnewayLocal(wiring_send_service_pt sendService, char *request);
+static celix_status_t wiringAdmin_sendStreamLocal(wiring_send_service_pt sendService, wiring_stream_reader_pt request, wiring_stream_writer_pt reply, int* replyStatus);
+static celix_status_t wiringAdmin_streamCount(void* handle, const char* data, size_t length);
+
+static celix_status_t wiringAdmin_getCurlHandle(wiring_admin_pt admin, char* url, CURL** curl);
+static void wiringAdmin_releaseCurlHandle(wiring_admin_pt admin, char* url, CURL* curl);
+static void wiringAdmin_removeCurlHandlePool(wiring_admin_pt admin, char* url);
+
+static celix_status_t wiringAdmin_startAsync(wiring_admin_pt admin);
+static void wiringAdmin_stopAsync(wiring_admin_pt admin);
+static void* wiringAdmin_localAsyncRun(void* data);
+static void* wiringAdmin_asyncRun(void* data);
+static void wiringAdmin_asyncComplete(wiring_async_request_pt asyncRequest, celix_status_t status, CURLcode res);
 
 
 celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *admin) {
@@ -66,10 +171,25 @@ celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *ad
     } else {
         (*admin)->context = context;
 
+        char* compression = NULL;
+        char* compressionThreshold = NULL;
+
+        bundleContext_getProperty(context, WIRING_ADMIN_COMPRESSION, &compression);
+        if (compression == NULL) {
+            compression = (char*) DEFAULT_WA_COMPRESSION;
+        }
+
+        (*admin)->compression = (strcmp(compression, WIRING_ADMIN_COMPRESSION_DEFLATE) == 0);
+        if (!(*admin)->compression && strcmp(compression, WIRING_ADMIN_COMPRESSION_NONE) != 0) {
+            printf("%s: Unknown compression %s, using %s\n", TAG, compression, WIRING_ADMIN_COMPRESSION_NONE);
+        }
+
+        bundleContext_getProperty(context, WIRING_ADMIN_COMPRESSION_THRESHOLD, &compressionThreshold);
+        (*admin)->compressionThreshold = (compressionThreshold != NULL) ? strtoul(compressionThreshold, NULL, 10) : DEFAULT_WA_COMPRESSION_THRESHOLD;
+
         (*admin)->wiringSendServices = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
         (*admin)->wiringSendRegistrations = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
-        (*admin)->wiringReceiveServices = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
-        (*admin)->wiringReceiveTracker = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
+        (*admin)->curlHandlePools = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
 
         (*admin)->adminProperties = properties_create();
 
@@ -78,6 +198,13 @@ celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *ad
 
         celixThreadMutex_create(&(*admin)->exportedWiringEndpointLock, NULL);
         celixThreadMutex_create(&(*admin)->importedWiringEndpointLock, NULL);
+        celixThreadMutex_create(&(*admin)->curlHandlePoolsLock, NULL);
+
+        status = wiringReceiveRegistry_create(context, TAG, &(*admin)->receiveRegistry);
+
+        if (status == CELIX_SUCCESS) {
+            status = wiringAdmin_startAsync(*admin);
+        }
     }
 
     return status;
@@ -100,6 +227,11 @@ celix_status_t wiringAdmin_startWebserver(bundle_context_pt context, wiring_admi
     char *port = NULL;
     char *ip = NULL;
     char *detectedIp = NULL;
+    char *numThreads = NULL;
+    char *keepAlive = NULL;
+    char *requestTimeout = NULL;
+    char *maxRequestSize = NULL;
+    char detectedNumThreads[16];
 
     bundleContext_getProperty(context, NODE_DISCOVERY_NODE_WA_PORT, &port);
     if (port == NULL) {
@@ -122,6 +254,29 @@ celix_status_t wiringAdmin_startWebserver(bundle_context_pt context, wiring_admi
         ip = detectedIp;
     }
 
+    bundleContext_getProperty(context, WIRING_ADMIN_NUM_THREADS, &numThreads);
+    if (numThreads == NULL) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+        snprintf(detectedNumThreads, sizeof(detectedNumThreads), "%ld", ((cpus > 0) ? cpus : 1) * DEFAULT_WA_THREADS_PER_CPU);
+        numThreads = detectedNumThreads;
+    }
+
+    bundleContext_getProperty(context, WIRING_ADMIN_KEEP_ALIVE, &keepAlive);
+    if (keepAlive == NULL) {
+        keepAlive = (char *) DEFAULT_WA_KEEP_ALIVE;
+    }
+
+    bundleContext_getProperty(context, WIRING_ADMIN_REQUEST_TIMEOUT_MS, &requestTimeout);
+    if (requestTimeout == NULL) {
+        requestTimeout = (char *) DEFAULT_WA_REQUEST_TIMEOUT_MS;
+    }
+
+    bundleContext_getProperty(context, WIRING_ADMIN_MAX_REQUEST_SIZE, &maxRequestSize);
+    (*admin)->maxRequestSize = (maxRequestSize != NULL) ? strtoull(maxRequestSize, NULL, 10) : 0;
+
+    printf("%s: Starting webserver with %s worker threads, keep-alive %s\n", TAG, numThreads, keepAlive);
+
     // Prepare callbacks structure. We have only one callback, the rest are NULL.
     struct mg_callbacks callbacks;
     memset(&callbacks, 0, sizeof(callbacks));
@@ -129,7 +284,12 @@ celix_status_t wiringAdmin_startWebserver(bundle_context_pt context, wiring_admi
 
     do {
         char newPort[10];
-        const char *options[] = { "listening_ports", port, NULL };
+        const char *options[] = {
+                "listening_ports", port,
+                "num_threads", numThreads,
+                "enable_keep_alive", keepAlive,
+                "request_timeout_ms", requestTimeout,
+                NULL };
 
         (*admin)->ctx = mg_start(&callbacks, (*admin), options);
 
@@ -182,18 +342,52 @@ celix_status_t wiringAdmin_destroy(wiring_admin_pt* admin) {
 
     status = wiringAdmin_stopWebserver(*admin);
 
-    celixThreadMutex_lock(&((*admin)->exportedWiringEndpointLock));
-    hashMap_destroy((*admin)->wiringReceiveServices, false, false);
-    hashMap_destroy((*admin)->wiringReceiveTracker, false, false);
-    celixThreadMutex_unlock(&((*admin)->exportedWiringEndpointLock));
+    wiringAdmin_stopAsync(*admin);
+
+    if ((*admin)->asyncMulti != NULL) {
+        curl_multi_cleanup((*admin)->asyncMulti);
+    }
+    if ((*admin)->asyncWakeupPipe[0] >= 0) {
+        close((*admin)->asyncWakeupPipe[0]);
+        close((*admin)->asyncWakeupPipe[1]);
+    }
+    arrayList_destroy((*admin)->asyncQueue);
+    arrayList_destroy((*admin)->asyncActive);
+    arrayList_destroy((*admin)->localAsyncQueue);
+    celixThreadCondition_destroy(&((*admin)->localAsyncQueued));
+    celixThreadMutex_destroy(&((*admin)->asyncQueueLock));
+
     celixThreadMutex_destroy(&((*admin)->exportedWiringEndpointLock));
 
+    // the webserver and the local async workers are stopped, so no request reaches the receivers anymore
+    if ((*admin)->receiveRegistry != NULL) {
+        wiringReceiveRegistry_destroy(&(*admin)->receiveRegistry);
+    }
+
     celixThreadMutex_lock(&((*admin)->importedWiringEndpointLock));
     hashMap_destroy((*admin)->wiringSendServices, false, false);
     hashMap_destroy((*admin)->wiringSendRegistrations, false, false);
     celixThreadMutex_unlock(&((*admin)->importedWiringEndpointLock));
     celixThreadMutex_destroy(&((*admin)->importedWiringEndpointLock));
 
+    celixThreadMutex_lock(&((*admin)->curlHandlePoolsLock));
+    hash_map_iterator_pt iter = hashMapIterator_create((*admin)->curlHandlePools);
+    while (hashMapIterator_hasNext(iter)) {
+        curl_handle_pool_pt pool = hashMapIterator_nextValue(iter);
+        int i;
+
+        for (i = 0; i < arrayList_size(pool->idleHandles); i++) {
+            curl_easy_cleanup(arrayList_get(pool->idleHandles, i));
+        }
+
+        arrayList_destroy(pool->idleHandles);
+        free(pool);
+    }
+    hashMapIterator_destroy(iter);
+    hashMap_destroy((*admin)->curlHandlePools, true, false);
+    celixThreadMutex_unlock(&((*admin)->curlHandlePoolsLock));
+    celixThreadMutex_destroy(&((*admin)->curlHandlePoolsLock));
+
     properties_destroy((*admin)->adminProperties);
 
     free(*admin);
@@ -207,34 +401,13 @@ celix_status_t wiringAdmin_stop(wiring_admin_pt admin) {
 
     celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
 
-    // stop tracker
-    hash_map_iterator_pt iter = hashMapIterator_create(admin->wiringReceiveTracker);
-
-    while (hashMapIterator_hasNext(iter)) {
-        service_tracker_pt wiringReceiveTracker = (service_tracker_pt) hashMapIterator_nextValue(iter);
-
-        if (serviceTracker_close(wiringReceiveTracker) == CELIX_SUCCESS) {
-            serviceTracker_destroy(wiringReceiveTracker);
-        }
-    }
-    hashMapIterator_destroy(iter);
-
-    hashMap_clear(admin->wiringReceiveTracker, false, false);
-
+    wiringReceiveRegistry_untrackAll(admin->receiveRegistry);
     wiringAdmin_stopWebserver(admin);
 
-    iter = hashMapIterator_create(admin->wiringReceiveServices);
-
-    while (hashMapIterator_hasNext(iter)) {
-        array_list_pt wiringReceiveServiceList = hashMapIterator_nextValue(iter);
-        arrayList_destroy(wiringReceiveServiceList);
-    }
-
-    hashMapIterator_destroy(iter);
-    hashMap_clear(admin->wiringReceiveServices, false, false);
-
     celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
 
+    wiringAdmin_stopAsync(admin);
+
     return status;
 }
 
@@ -246,43 +419,115 @@ static int wiringAdmin_callback(struct mg_connection *conn) {
     if (request_info->uri != NULL) {
         wiring_admin_pt admin = request_info->user_data;
 
-        if (hashMap_size(admin->wiringReceiveServices) == 0) {
-            printf("%s: No wiringReceiveServices available\n", TAG);
-        }
-
         if (strcmp("POST", request_info->request_method) == 0) {
+            const char* contentEncoding = mg_get_header(conn, "Content-Encoding");
+            const char* acceptEncoding = mg_get_header(conn, "Accept-Encoding");
 
-            celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
+            // every exported wire is published as <url>/<wireId>
+            const char* wireId = request_info->uri;
+            if (*wireId == '/') {
+                wireId++;
+            }
 
-            uint64_t datalength = request_info->content_length;
-            char* data = malloc(datalength + 1);
-            mg_read(conn, data, datalength);
-            data[datalength] = '\0';
+            // streamed requests for receivers that cannot stream are handled like any other request below
+            if (request_info->query_string != NULL && strcmp(request_info->query_string, WIRING_ADMIN_STREAM_QUERY) == 0 && contentEncoding == NULL
+                    && wiringAdmin_handleStream(admin, conn, wireId)) {
+                return 1;
+            }
 
-            char *response = NULL;
+            uint64_t datalength = (request_info->content_length > 0) ? request_info->content_length : 0;
+            size_t dataread = 0;
 
-            hash_map_iterator_pt iter = hashMapIterator_create(admin->wiringReceiveServices);
-            while (hashMapIterator_hasNext(iter)) {
-                array_list_pt wiringReceiveServiceList = hashMapIterator_nextValue(iter);
+            if (admin->maxRequestSize > 0 && datalength > admin->maxRequestSize) {
+                char discard[1024];
 
-                if (arrayList_size(wiringReceiveServiceList) > 0) {
-                    //		printf("WIRING_ADMIN: size of wiringReceiveServiceList is %d\n", arrayList_size(wiringReceiveServiceList));
-                    // TODO: we do not support mulitple wiringReceivers?
-                    wiring_receive_service_pt wiringReceiveService = (wiring_receive_service_pt) arrayList_get(wiringReceiveServiceList, 0);
-                    if (wiringReceiveService->receive(wiringReceiveService->handle, data, &response) != CELIX_SUCCESS) {
-                        response = NULL;
-                    }
+                printf("%s: Rejecting request of %llu bytes, limit is %llu\n", TAG, (unsigned long long) datalength, (unsigned long long) admin->maxRequestSize);
 
-                    break;
-                } else {
-                    printf("%s: wiringReceiveServiceList is empty\n", TAG);
+                // the body has to be consumed, otherwise it would be parsed as the next request on this connection
+                while (mg_read(conn, discard, sizeof(discard)) > 0) {
+                }
+
+                mg_write(conn, too_large_response_headers, strlen(too_large_response_headers));
+
+                return 1;
+            }
+
+            char* data = NULL;
+
+            // the body is read without holding any admin lock
+            if (wiringAdmin_readBody(admin, conn, request_info->content_length, &data, &dataread) != CELIX_SUCCESS) {
+                printf("%s: Rejecting request for %s, it could not be read within the limit of %llu bytes\n", TAG, request_info->uri, (unsigned long long) admin->maxRequestSize);
+                mg_write(conn, too_large_response_headers, strlen(too_large_response_headers));
+
+                return 1;
+            }
+
+            if (contentEncoding != NULL && strcasecmp(contentEncoding, WIRING_ADMIN_COMPRESSION_DEFLATE) == 0) {
+                char* inflated = NULL;
+                size_t inflatedLength = 0;
+
+                if (wiringAdmin_inflate(admin, data, dataread, &inflated, &inflatedLength) != CELIX_SUCCESS) {
+                    printf("%s: Could not inflate request for %s\n", TAG, request_info->uri);
+                    mg_write(conn, bad_request_response_headers, strlen(bad_request_response_headers));
+                    free(data);
+
+                    return 1;
                 }
+
+                free(data);
+                data = inflated;
+                dataread = inflatedLength;
+            }
+
+            char *response = NULL;
+            bool oneway = (request_info->query_string != NULL && strcmp(request_info->query_string, WIRING_ADMIN_ONEWAY_QUERY) == 0);
+
+            // the sender of a one-way request does not wait for it to be handled
+            if (oneway) {
+                mg_write(conn, no_content_response_headers, strlen(no_content_response_headers));
+            }
+
+            celix_status_t receiveStatus = CELIX_SUCCESS;
+
+            if (request_info->query_string != NULL && strcmp(request_info->query_string, WIRING_ADMIN_BATCH_QUERY) == 0) {
+                receiveStatus = wiringReceiveRegistry_receiveBatch(admin->receiveRegistry, wireId, data, dataread, &response);
+            } else {
+                receiveStatus = wiringReceiveRegistry_receive(admin->receiveRegistry, wireId, data, &response);
+            }
+
+            if (receiveStatus == CELIX_ILLEGAL_ARGUMENT) {
+                printf("%s: No wiringReceiveService available for wireId %s%s\n", TAG, wireId, oneway ? ", one-way request dropped" : "");
+            } else if (receiveStatus == CELIX_INVALID_SYNTAX) {
+                printf("%s: Discarding malformed batch for wireId %s\n", TAG, wireId);
+            } else if (receiveStatus != CELIX_SUCCESS) {
+                printf("%s: Could not handle request for wireId %s (status %d)\n", TAG, wireId, receiveStatus);
             }
-            hashMapIterator_destroy(iter);
 
-            if (response != NULL) {
-                mg_write(conn, data_response_headers, strlen(data_response_headers));
-                mg_write(conn, response, strlen(response));
+            if (oneway) {
+                free(response);
+            } else if (receiveStatus == CELIX_ILLEGAL_ARGUMENT) {
+                mg_write(conn, not_found_response_headers, strlen(not_found_response_headers));
+            } else if (receiveStatus == CELIX_INVALID_SYNTAX) {
+                mg_write(conn, bad_request_response_headers, strlen(bad_request_response_headers));
+            } else if (receiveStatus != CELIX_SUCCESS) {
+                mg_write(conn, internal_error_response_headers, strlen(internal_error_response_headers));
+            } else if (response != NULL) {
+                size_t responseLength = strlen(response);
+                char* deflated = NULL;
+                size_t deflatedLength = 0;
+
+                // only senders announcing it get a compressed reply, curl inflates it transparently
+                if (admin->compression && responseLength >= admin->compressionThreshold && acceptEncoding != NULL
+                        && strstr(acceptEncoding, WIRING_ADMIN_COMPRESSION_DEFLATE) != NULL
+                        && wiringAdmin_deflate(response, responseLength, &deflated, &deflatedLength) == CELIX_SUCCESS) {
+                    mg_printf(conn, data_response_headers, (unsigned long) deflatedLength, CONTENT_ENCODING_DEFLATE_HEADER "\r\n");
+                    mg_write(conn, deflated, deflatedLength);
+
+                    free(deflated);
+                } else {
+                    mg_printf(conn, data_response_headers, (unsigned long) responseLength, "");
+                    mg_write(conn, response, responseLength);
+                }
 
                 free(response);
             } else {
@@ -294,8 +539,6 @@ static int wiringAdmin_callback(struct mg_connection *conn) {
         } else {
             printf("%s: Received HTTP Request, but no RSA_Inaetics callback is installed. Discarding request.\n", TAG);
         }
-
-        celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
     } else {
         printf("%s: Received URI is NULL\n", TAG);
     }
@@ -303,131 +546,186 @@ static int wiringAdmin_callback(struct mg_connection *conn) {
     return result;
 }
 
-static celix_status_t wiringAdmin_createWiringReceiveTracker(wiring_admin_pt admin, service_tracker_pt *tracker, char* wireId) {
+/*
+ * Reads the body of a request, sized by Content-Length or sent chunked. Fails, after consuming the
+ * rest of the body, if it does not fit within the configured maximum request size.
+ */
+static celix_status_t wiringAdmin_readBody(wiring_admin_pt admin, struct mg_connection *conn, int64_t contentLength, char** data, size_t* length) {
     celix_status_t status = CELIX_SUCCESS;
 
-    service_tracker_customizer_pt customizer = NULL;
+    wiring_buffer_pt buffer = NULL;
+
+    status = wiringBuffer_create((contentLength > 0 && contentLength <= WIRING_BUFFER_MAX_SIZE_HINT) ? contentLength : 0, &buffer);
+
+    while (status == CELIX_SUCCESS && (contentLength < 0 || buffer->size < (uint64_t) contentLength)) {
+        size_t available = buffer->capacity - buffer->size - 1;
+        int bytes = 0;
+
+        if (available == 0) {
+            status = wiringBuffer_reserve(buffer, buffer->capacity * 2);
+            continue;
+        }
+
+        bytes = mg_read(conn, &buffer->data[buffer->size], available);
+
+        if (bytes <= 0) {
+            break;
+        }
 
-    status = serviceTrackerCustomizer_create(admin, wiringAdmin_wiringReceiveAdding, wiringAdmin_wiringReceiveAdded, wiringAdmin_wiringReceiveModified, wiringAdmin_wiringReceiveRemoved, &customizer);
+        buffer->size += bytes;
+        buffer->data[buffer->size] = '\0';
+
+        if (admin->maxRequestSize > 0 && buffer->size > admin->maxRequestSize) {
+            status = CELIX_ILLEGAL_ARGUMENT;
+        }
+    }
 
     if (status == CELIX_SUCCESS) {
-        char filter[512];
-        snprintf(filter, 512, "(&(%s=%s)(%s=%s))", (char*) OSGI_FRAMEWORK_OBJECTCLASS, (char*) INAETICS_WIRING_RECEIVE_SERVICE, (char*) INAETICS_WIRING_WIRE_ID, wireId);
+        status = wiringBuffer_detach(buffer, data, length);
+    } else {
+        char discard[1024];
 
-        status = serviceTracker_createWithFilter(admin->context, filter, customizer, tracker);
+        // the body has to be consumed, otherwise it would be parsed as the next request on this connection
+        while (mg_read(conn, discard, sizeof(discard)) > 0) {
+        }
     }
 
+    wiringBuffer_destroy(buffer);
+
     return status;
 }
 
-static celix_status_t wiringAdmin_wiringReceiveAdding(void * handle, service_reference_pt reference, void **service) {
-    celix_status_t status = CELIX_SUCCESS;
-
-    wiring_admin_pt admin = handle;
+/*
+ * Hands a streamed request to a receiver of the wire chunk by chunk and streams its reply back.
+ * Returns false, without consuming the request, if the selected receiver cannot stream.
+ */
+static bool wiringAdmin_handleStream(wiring_admin_pt admin, struct mg_connection *conn, const char* wireId) {
+    bool handled = true;
+
+    struct stream_connection stream = { conn, false, false };
+    struct wiring_stream_reader reader = { &stream, wiringAdmin_streamRead };
+    struct wiring_stream_writer writer = { &stream, wiringAdmin_streamWrite };
+    celix_status_t receiveStatus = CELIX_SUCCESS;
+    bool streamed = false;
+
+    if (wiringReceiveRegistry_receiveStream(admin->receiveRegistry, wireId, &reader, &writer, &streamed, &receiveStatus) != CELIX_SUCCESS) {
+        printf("%s: No wiringReceiveService available for wireId %s\n", TAG, wireId);
+        wiringAdmin_streamDrain(&stream);
+        mg_write(conn, not_found_response_headers, strlen(not_found_response_headers));
+    } else if (!streamed) {
+        handled = false;
+    } else {
+        // whatever the receiver left unread is discarded
+        wiringAdmin_streamDrain(&stream);
 
-    status = bundleContext_getService(admin->context, reference, service);
+        if (!stream.headersSent && receiveStatus == CELIX_SUCCESS) {
+            mg_write(conn, no_content_response_headers, strlen(no_content_response_headers));
+        } else {
+            if (!stream.headersSent) {
+                mg_write(conn, stream_response_headers, strlen(stream_response_headers));
+            }
+            mg_printf(conn, "0\r\n%s: %d\r\n\r\n", WIRING_ADMIN_STREAM_STATUS_HEADER, receiveStatus);
+        }
+    }
 
-    return status;
+    return handled;
 }
 
-static celix_status_t wiringAdmin_wiringReceiveAdded(void * handle, service_reference_pt reference, void * service) {
+/*
+ * civetweb reports the end of a chunked body as 0 or, once read past the last chunk, as -1. Both end
+ * the stream, and the connection is not read any further as it is closed after a streamed request.
+ */
+static celix_status_t wiringAdmin_streamRead(void* handle, char* buffer, size_t size, size_t* length) {
     celix_status_t status = CELIX_SUCCESS;
 
-    wiring_admin_pt admin = handle;
-    wiring_receive_service_pt wiringReceiveService = (wiring_receive_service_pt) service;
-    array_list_pt wiringReceiveServiceList = hashMap_get(admin->wiringReceiveServices, wiringReceiveService->wireId);
+    struct stream_connection* stream = handle;
+    int bytes = 0;
 
-    printf("%s: wiringAdmin_wiringReceiveAdded, service w/ wireId %s added\n", TAG, wiringReceiveService->wireId);
-
-    if (wiringReceiveServiceList == NULL) {
-        arrayList_create(&wiringReceiveServiceList);
-        hashMap_put(admin->wiringReceiveServices, wiringReceiveService->wireId, wiringReceiveServiceList);
+    if (!stream->ended && size > 0) {
+        bytes = mg_read(stream->conn, buffer, size);
     }
 
-    arrayList_add(wiringReceiveServiceList, wiringReceiveService);
-
-    return status;
-}
+    if (bytes <= 0) {
+        stream->ended = true;
+        bytes = 0;
+    }
 
-static celix_status_t wiringAdmin_wiringReceiveModified(void * handle, service_reference_pt reference, void * service) {
-    celix_status_t status = CELIX_SUCCESS;
+    *length = bytes;
 
     return status;
 }
 
-static celix_status_t wiringAdmin_wiringReceiveRemoved(void * handle, service_reference_pt reference, void * service) {
+// the headers of the reply are sent with its first chunk, a reply without any data is answered with 204
+static celix_status_t wiringAdmin_streamWrite(void* handle, const char* data, size_t length) {
     celix_status_t status = CELIX_SUCCESS;
 
-    wiring_admin_pt admin = handle;
-    wiring_receive_service_pt wiringReceiveService = (wiring_receive_service_pt) service;
-    array_list_pt wiringReceiveServiceList = hashMap_get(admin->wiringReceiveServices, wiringReceiveService->wireId);
+    struct stream_connection* stream = handle;
 
-    if (wiringReceiveServiceList != NULL) {
-        arrayList_removeElement(wiringReceiveServiceList, wiringReceiveService);
-
-        printf("%s: wiringAdmin_wiringReceiveRemoved, service w/ wireId %s removed!\n", TAG, wiringReceiveService->wireId);
+    if (length > 0) {
+        if (!stream->headersSent) {
+            mg_write(stream->conn, stream_response_headers, strlen(stream_response_headers));
+            stream->headersSent = true;
+        }
 
-        if (arrayList_size(wiringReceiveServiceList) == 0) {
-            arrayList_destroy(wiringReceiveServiceList);
-            hashMap_remove(admin->wiringReceiveServices, wiringReceiveService->wireId);
+        if (mg_printf(stream->conn, "%lx\r\n", (unsigned long) length) <= 0 || mg_write(stream->conn, data, length) != (int) length
+                || mg_write(stream->conn, "\r\n", 2) != 2) {
+            status = CELIX_FILE_IO_EXCEPTION;
         }
-    } else {
-        printf("%s: wiringAdmin_wiringReceiveRemoved, service w/ wireId %s not found!\n", TAG, wiringReceiveService->wireId);
     }
 
     return status;
 }
 
+static void wiringAdmin_streamDrain(struct stream_connection* stream) {
+    char discard[1024];
+    size_t length = 0;
+
+    do {
+        wiringAdmin_streamRead(stream, discard, sizeof(discard), &length);
+    } while (length > 0);
+}
+
 celix_status_t wiringAdmin_exportWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt* wEndpointDescription) {
     celix_status_t status = CELIX_SUCCESS;
 
     celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
 
-    if (hashMap_size(admin->wiringReceiveTracker) == 0) {
+    if (wiringReceiveRegistry_getTrackedCount(admin->receiveRegistry) == 0) {
         status = wiringAdmin_startWebserver(admin->context, &admin);
     }
 
     if (status == CELIX_SUCCESS) {
-        char* fwuuid = NULL;
-
-        status = bundleContext_getProperty(admin->context, OSGI_FRAMEWORK_FRAMEWORK_UUID, &fwuuid);
-
-        if (status == CELIX_SUCCESS) {
-            char* wireId = NULL;
-            properties_pt props = properties_create();
-
-            printf("%s: HTTP Wiring Endpoint running at %s\n", TAG, admin->url);
+        printf("%s: HTTP Wiring Endpoint running at %s\n", TAG, admin->url);
 
-            status = wiringEndpointDescription_create(NULL, props, wEndpointDescription);
+        status = wiringReceiveRegistry_createEndpoint(admin->receiveRegistry, WIRING_ADMIN_PROPERTIES_CONFIG_VALUE, wEndpointDescription);
+    }
 
-            properties_set(props, WIRING_ADMIN_PROPERTIES_CONFIG_KEY, WIRING_ADMIN_PROPERTIES_CONFIG_VALUE);
-            properties_set(props, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY, admin->url);
-            properties_set(props, (char*) OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, fwuuid);
+    if (status == CELIX_SUCCESS) {
+        properties_pt props = (*wEndpointDescription)->properties;
+        char* wireId = properties_get(props, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+        char wireUrl[MAX_URL_LENGTH + MAX_WIRE_ID_LENGTH];
 
-            wireId = properties_get(props, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+        snprintf(wireUrl, sizeof(wireUrl), "%s/%s", admin->url, wireId);
 
-            printf("%s: wiringEndpointDescription_create w/ wireId %s started\n", TAG, wireId);
+        properties_set(props, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY, wireUrl);
 
-            if (status == CELIX_SUCCESS) {
-                service_tracker_pt tracker = NULL;
-                status = wiringAdmin_createWiringReceiveTracker(admin, &tracker, wireId);
+        if (admin->compression) {
+            properties_set(props, WIRING_ENDPOINT_DESCRIPTION_COMPRESSION_KEY, WIRING_ADMIN_COMPRESSION_DEFLATE);
+        }
 
-                if (status == CELIX_SUCCESS) {
-                    status = serviceTracker_open(tracker);
+        status = wiringReceiveRegistry_track(admin->receiveRegistry, *wEndpointDescription);
 
-                    if (status == CELIX_SUCCESS) {
-                        hashMap_put(admin->wiringReceiveTracker, *wEndpointDescription, tracker);
-                        printf("%s: WiringReceiveTracker w/ wireId %s started\n", TAG, wireId);
-                    } else {
-                        serviceTracker_destroy(tracker);
-                    }
-                }
-            }
+        if (status != CELIX_SUCCESS) {
+            wiringEndpointDescription_destroy(wEndpointDescription);
         }
     } else {
         printf("%s: Cannot export Wiring Endpoint\n", TAG);
     }
 
+    if (wiringReceiveRegistry_getTrackedCount(admin->receiveRegistry) == 0) {
+        wiringAdmin_stopWebserver(admin);
+    }
+
     celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
 
     return status;
@@ -440,18 +738,10 @@ celix_status_t wiringAdmin_removeExportedWiringEndpoint(wiring_admin_pt admin, w
         status = CELIX_ILLEGAL_ARGUMENT;
     } else {
         celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
-        service_tracker_pt wiringReceiveTracker = NULL;
-
-        wiringReceiveTracker = hashMap_remove(admin->wiringReceiveTracker, wEndpointDescription);
 
-        if (wiringReceiveTracker != NULL) {
-            if (serviceTracker_close(wiringReceiveTracker) == CELIX_SUCCESS) {
-                serviceTracker_destroy(wiringReceiveTracker);
-            }
-
-            if (hashMap_size(admin->wiringReceiveTracker) == 0) {
-                wiringAdmin_stopWebserver(admin);
-            }
+        if (wiringReceiveRegistry_untrack(admin->receiveRegistry, wEndpointDescription) == CELIX_SUCCESS
+                && wiringReceiveRegistry_getTrackedCount(admin->receiveRegistry) == 0) {
+            wiringAdmin_stopWebserver(admin);
         }
 
         wiringEndpointDescription_destroy(&wEndpointDescription);
@@ -472,25 +762,40 @@ celix_status_t wiringAdmin_importWiringEndpoint(wiring_admin_pt admin, wiring_en
     } else {
         service_registration_pt wiringSendServiceReg = NULL;
         char* wireId = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
-
-        properties_pt props = properties_create();
-        properties_set(props, (char*) INAETICS_WIRING_WIRE_ID, wireId);
+        char* endpointFwuuid = properties_get(wEndpointDescription->properties, (char*) OSGI_RSA_ENDPOINT_FRAMEWORK_UUID);
+        char* fwuuid = NULL;
 
         wiringSendService->wiringEndpointDescription = wEndpointDescription;
-        wiringSendService->send = wiringAdmin_send;
         wiringSendService->admin = admin;
 
-        status = bundleContext_registerService(admin->context, (char *) INAETICS_WIRING_SEND_SERVICE, wiringSendService, props, &wiringSendServiceReg);
+        bundleContext_getProperty(admin->context, OSGI_FRAMEWORK_FRAMEWORK_UUID, &fwuuid);
 
-        if (status == CELIX_SUCCESS) {
+        // wires exported by this framework call the receive service directly instead of going through HTTP
+        if (fwuuid != NULL && endpointFwuuid != NULL && strcmp(fwuuid, endpointFwuuid) == 0) {
+            printf("%s: wireId %s is exported by this framework, using direct calls\n", TAG, wireId);
+
+            wiringSendService->send = wiringAdmin_sendLocal;
+            wiringSendService->sendSized = wiringAdmin_sendSizedLocal;
+            wiringSendService->sendAsync = wiringAdmin_sendAsyncLocal;
+            wiringSendService->sendBatch = wiringAdmin_sendBatchLocal;
+            wiringSendService->sendOneway = wiringAdmin_sendOnewayLocal;
+            wiringSendService->sendStream = wiringAdmin_sendStreamLocal;
+        } else {
+            wiringSendService->send = wiringAdmin_send;
+            wiringSendService->sendSized = wiringAdmin_sendSized;
+            wiringSendService->sendAsync = wiringAdmin_sendAsync;
+            wiringSendService->sendBatch = wiringAdmin_sendBatch;
+            wiringSendService->sendOneway = wiringAdmin_sendOneway;
+            wiringSendService->sendStream = wiringAdmin_sendStream;
+        }
+
+        status = wiring_registerSendService(admin->context, TAG, wiringSendService, &wiringSendServiceReg);
 
+        if (status == CELIX_SUCCESS) {
             hashMap_put(admin->wiringSendServices, wEndpointDescription, wiringSendService);
             hashMap_put(admin->wiringSendRegistrations, wEndpointDescription, wiringSendServiceReg);
-
-            printf("%s: SEND SERVICE sucessfully registered w/ wireId %s\n", TAG, wireId);
         } else {
-            printf("%s: could not register SEND SERVICE w/ wireId %s\n", TAG, wireId);
-
+            free(wiringSendService);
         }
     }
 
@@ -514,87 +819,911 @@ celix_status_t wiringAdmin_removeImportedWiringEndpoint(wiring_admin_pt admin, w
         free(wiringSendService);
     }
 
+    // the idle connections of the wire are of no use anymore
+    char* url = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY);
+
+    if (url != NULL) {
+        char poolUrl[MAX_URL_LENGTH + MAX_WIRE_ID_LENGTH + sizeof(WIRING_ADMIN_ONEWAY_QUERY) + sizeof(WIRING_ADMIN_BATCH_QUERY) + 1];
+
+        wiringAdmin_removeCurlHandlePool(admin, url);
+        snprintf(poolUrl, sizeof(poolUrl), "%s?%s", url, WIRING_ADMIN_BATCH_QUERY);
+        wiringAdmin_removeCurlHandlePool(admin, poolUrl);
+        snprintf(poolUrl, sizeof(poolUrl), "%s?%s", url, WIRING_ADMIN_ONEWAY_QUERY);
+        wiringAdmin_removeCurlHandlePool(admin, poolUrl);
+    }
+
     celixThreadMutex_unlock(&admin->importedWiringEndpointLock);
 
     return status;
 }
 
 static celix_status_t wiringAdmin_send(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus) {
+    return wiringAdmin_sendSized(sendService, request, strlen(request), reply, replyStatus);
+}
 
-    celix_status_t status = CELIX_SUCCESS;
+static celix_status_t wiringAdmin_sendSized(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus) {
+    char* url = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY);
 
-    struct post post;
-    post.readptr = request;
-    post.size = strlen(request);
+    return wiringAdmin_sendRequest(sendService, url, request, requestLength, reply, replyStatus);
+}
 
-    struct get get;
-    get.size = 0;
-    get.writeptr = malloc(1);
+static celix_status_t wiringAdmin_sendBatch(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses) {
+    celix_status_t status = CELIX_SUCCESS;
 
     char* url = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY);
+    char batchUrl[MAX_URL_LENGTH + MAX_WIRE_ID_LENGTH + sizeof(WIRING_ADMIN_BATCH_QUERY) + 1];
+    char* data = NULL;
+    size_t length = 0;
+    char* reply = NULL;
+    int replyStatus = 0;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        replies[i] = NULL;
+        replyStatuses[i] = 0;
+    }
+
+    // batches go through their own pooled handles, as the url of a handle is fixed
+    snprintf(batchUrl, sizeof(batchUrl), "%s?%s", url, WIRING_ADMIN_BATCH_QUERY);
+
+    status = wiringBatch_encode(count, requests, NULL, &data, &length);
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringAdmin_sendRequest(sendService, batchUrl, data, length, &reply, &replyStatus);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        if (reply == NULL) {
+            // the batch as a whole was not accepted, e.g. because the wire is unknown
+            for (i = 0; i < count; i++) {
+                replyStatuses[i] = replyStatus;
+            }
+        } else {
+            status = wiringBatch_decodeReplies(reply, strlen(reply), count, replies, replyStatuses);
+        }
+    }
+
+    free(reply);
+    free(data);
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_sendRequest(wiring_send_service_pt sendService, char* url, const char *request, size_t requestLength, char **reply, int* replyStatus) {
+
+    celix_status_t status = CELIX_SUCCESS;
+
+    const char* body = request;
+    size_t bodyLength = requestLength;
+
+    bool compress = wiringAdmin_useCompression(sendService);
+    char* deflated = NULL;
+    size_t deflatedLength = 0;
+
+    if (compress && requestLength >= sendService->admin->compressionThreshold && wiringAdmin_deflate(request, requestLength, &deflated, &deflatedLength) == CELIX_SUCCESS) {
+        body = deflated;
+        bodyLength = deflatedLength;
+    }
+
+    wiring_buffer_pt replyBuffer = NULL;
 
-    CURL *curl;
+    CURL *curl = NULL;
     CURLcode res;
 
-    curl = curl_easy_init();
-    if (!curl) {
-        status = CELIX_ILLEGAL_STATE;
-    } else {
+    status = wiringBuffer_create(0, &replyBuffer);
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringAdmin_getCurlHandle(sendService->admin, url, &curl);
+    }
+
+    if (status == CELIX_SUCCESS) {
         long http_code = 0;
 
-        curl_easy_setopt(curl, CURLOPT_URL, url);
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_READFUNCTION, wiringAdmin_HTTPReqReadCallback);
-        curl_easy_setopt(curl, CURLOPT_READDATA, &post);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, wiringAdmin_HTTPReqWrite);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&get);
-        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 2L);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 2L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, (curl_off_t)post.size);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, (deflated != NULL) ? &deflate_request_headers : NULL);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) bodyLength);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, compress ? WIRING_ADMIN_COMPRESSION_DEFLATE : NULL);
+        wiringBuffer_attachToCurl(replyBuffer, curl);
         res = curl_easy_perform(curl);
 
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
 
-        if (http_code == 200 && res != CURLE_ABORTED_BY_CALLBACK) {
+        if (replyBuffer->status != CELIX_SUCCESS) {
+            status = replyBuffer->status;
+        } else if (http_code == 200 && res != CURLE_ABORTED_BY_CALLBACK) {
             *replyStatus = res;
-            *reply = get.writeptr;
+            status = wiringBuffer_detach(replyBuffer, reply, NULL);
         } else {
             *replyStatus = http_code;
         }
 
-        curl_easy_cleanup(curl);
+        wiringAdmin_releaseCurlHandle(sendService->admin, url, curl);
     }
 
+    wiringBuffer_destroy(replyBuffer);
+    free(deflated);
+
     return status;
 }
 
-static size_t wiringAdmin_HTTPReqReadCallback(void *ptr, size_t size, size_t nmemb, void *userp) {
-    struct post *post = userp;
+static celix_status_t wiringAdmin_sendAsync(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata) {
+    char* url = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY);
+
+    return wiringAdmin_queueRequest(sendService->admin, url, request, wiringAdmin_useCompression(sendService), callback, userdata);
+}
+
+/*
+ * One-way requests are driven by the event loop like asynchronous ones, without a callback. The
+ * receiving admin answers them before dispatching, so they occupy a connection only briefly.
+ */
+static celix_status_t wiringAdmin_sendOneway(wiring_send_service_pt sendService, char *request) {
+    char* url = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY);
+    char onewayUrl[MAX_URL_LENGTH + MAX_WIRE_ID_LENGTH + sizeof(WIRING_ADMIN_ONEWAY_QUERY) + 1];
+
+    snprintf(onewayUrl, sizeof(onewayUrl), "%s?%s", url, WIRING_ADMIN_ONEWAY_QUERY);
+
+    return wiringAdmin_queueRequest(sendService->admin, onewayUrl, request, wiringAdmin_useCompression(sendService), NULL, NULL);
+}
+
+/*
+ * Streamed requests do not use the pooled handles: they have no overall timeout, only a stalled
+ * transfer is given up, and their connection is closed afterwards. The request is uploaded chunked
+ * and not compressed.
+ */
+static celix_status_t wiringAdmin_sendStream(wiring_send_service_pt sendService, wiring_stream_reader_pt request, wiring_stream_writer_pt reply, int* replyStatus) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    char* url = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY);
+    char streamUrl[MAX_URL_LENGTH + MAX_WIRE_ID_LENGTH + sizeof(WIRING_ADMIN_STREAM_QUERY) + 1];
+
+    struct stream_transfer transfer;
+
+    memset(&transfer, 0, sizeof(transfer));
+
+    snprintf(streamUrl, sizeof(streamUrl), "%s?%s", url, WIRING_ADMIN_STREAM_QUERY);
 
-    if (post->size) {
-        *(char *) ptr = post->readptr[0];
-        post->readptr++;
-        post->size--;
-        return 1;
+    transfer.curl = curl_easy_init();
+    transfer.reader = request;
+    transfer.writer = reply;
+    transfer.status = CELIX_SUCCESS;
+
+    if (transfer.curl == NULL) {
+        status = CELIX_ILLEGAL_STATE;
+    } else {
+        long http_code = 0;
+        CURLcode res;
+
+        curl_easy_setopt(transfer.curl, CURLOPT_URL, streamUrl);
+        curl_easy_setopt(transfer.curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(transfer.curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(transfer.curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) -1);
+        curl_easy_setopt(transfer.curl, CURLOPT_HTTPHEADER, &stream_request_headers);
+        curl_easy_setopt(transfer.curl, CURLOPT_READFUNCTION, wiringAdmin_HTTPStreamReadCallback);
+        curl_easy_setopt(transfer.curl, CURLOPT_READDATA, &transfer);
+        curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, wiringAdmin_HTTPStreamWriteCallback);
+        curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer);
+        curl_easy_setopt(transfer.curl, CURLOPT_HEADERFUNCTION, wiringAdmin_HTTPStreamHeaderCallback);
+        curl_easy_setopt(transfer.curl, CURLOPT_HEADERDATA, &transfer);
+        curl_easy_setopt(transfer.curl, CURLOPT_CONNECTTIMEOUT, 2L);
+        curl_easy_setopt(transfer.curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+        curl_easy_setopt(transfer.curl, CURLOPT_LOW_SPEED_TIME, (long) WIRING_ADMIN_STREAM_STALL_TIMEOUT);
+
+        res = curl_easy_perform(transfer.curl);
+
+        curl_easy_getinfo(transfer.curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+        if (transfer.status != CELIX_SUCCESS) {
+            status = transfer.status;
+        } else if (http_code == 200 && transfer.receiveStatus != CELIX_SUCCESS) {
+            printf("%s: Streamed request to %s failed in the receiver with status %d\n", TAG, url, transfer.receiveStatus);
+            status = CELIX_ILLEGAL_STATE;
+        } else if (http_code == 200) {
+            *replyStatus = res;
+        } else {
+            *replyStatus = http_code;
+        }
     }
 
-    return 0;
+    if (transfer.curl != NULL) {
+        curl_easy_cleanup(transfer.curl);
+    }
+
+    return status;
 }
 
-static size_t wiringAdmin_HTTPReqWrite(void *contents, size_t size, size_t nmemb, void *userp) {
-    size_t realsize = size * nmemb;
-    struct get *mem = (struct get *) userp;
+// a NULL callback makes the request one-way, its outcome is dropped
+static celix_status_t wiringAdmin_queueRequest(wiring_admin_pt admin, char* url, char *request, bool compress, wiring_send_callback_pt callback, void* userdata) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_async_request_pt asyncRequest = calloc(1, sizeof(*asyncRequest));
+
+    if (!asyncRequest) {
+        status = CELIX_ENOMEM;
+    } else {
+        asyncRequest->admin = admin;
+        asyncRequest->callback = callback;
+        asyncRequest->userdata = userdata;
+
+        // the endpoint description might be gone by the time the request completes
+        asyncRequest->url = strdup(url);
+        asyncRequest->requestLength = strlen(request);
+        asyncRequest->request = malloc(asyncRequest->requestLength + 1);
+
+        if (asyncRequest->url == NULL || asyncRequest->request == NULL) {
+            status = CELIX_ENOMEM;
+        } else {
+            char* deflated = NULL;
+            size_t deflatedLength = 0;
+
+            memcpy(asyncRequest->request, request, asyncRequest->requestLength + 1);
+
+            // the request buffer only feeds the upload, so it is replaced by its compressed form
+            if (compress && asyncRequest->requestLength >= admin->compressionThreshold
+                    && wiringAdmin_deflate(asyncRequest->request, asyncRequest->requestLength, &deflated, &deflatedLength) == CELIX_SUCCESS) {
+                free(asyncRequest->request);
+                asyncRequest->request = deflated;
+                asyncRequest->requestLength = deflatedLength;
+                asyncRequest->deflated = true;
+            }
 
-    mem->writeptr = realloc(mem->writeptr, mem->size + realsize + 1);
-    if (mem->writeptr == NULL) {
+            status = wiringBuffer_create(0, &asyncRequest->replyBuffer);
+        }
+    }
 
-        printf("not enough memory (realloc returned NULL)");
-        exit(EXIT_FAILURE);
+    if (status == CELIX_SUCCESS) {
+        status = wiringAdmin_getCurlHandle(admin, asyncRequest->url, &asyncRequest->curl);
     }
 
-    memcpy(&(mem->writeptr[mem->size]), contents, realsize);
-    mem->size += realsize;
-    mem->writeptr[mem->size] = 0;
+    if (status == CELIX_SUCCESS) {
+        curl_easy_setopt(asyncRequest->curl, CURLOPT_HTTPHEADER, asyncRequest->deflated ? &deflate_request_headers : NULL);
+        curl_easy_setopt(asyncRequest->curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) asyncRequest->requestLength);
+        curl_easy_setopt(asyncRequest->curl, CURLOPT_POSTFIELDS, asyncRequest->request);
+        curl_easy_setopt(asyncRequest->curl, CURLOPT_ACCEPT_ENCODING, compress ? WIRING_ADMIN_COMPRESSION_DEFLATE : NULL);
+        curl_easy_setopt(asyncRequest->curl, CURLOPT_PRIVATE, asyncRequest);
+        wiringBuffer_attachToCurl(asyncRequest->replyBuffer, asyncRequest->curl);
+
+        celixThreadMutex_lock(&admin->asyncQueueLock);
+
+        if (admin->asyncRunning) {
+            arrayList_add(admin->asyncQueue, asyncRequest);
+        } else {
+            status = CELIX_ILLEGAL_STATE;
+        }
+
+        celixThreadMutex_unlock(&admin->asyncQueueLock);
+    }
 
-    return realsize;
+    if (status == CELIX_SUCCESS) {
+        // wake up the event loop; a full pipe already guarantees a pending wakeup
+        if (write(admin->asyncWakeupPipe[1], "", 1) < 0) {
+            // nothing to do
+        }
+    } else if (asyncRequest != NULL) {
+        if (asyncRequest->curl != NULL) {
+            wiringAdmin_releaseCurlHandle(admin, asyncRequest->url, asyncRequest->curl);
+        }
+        wiringBuffer_destroy(asyncRequest->replyBuffer);
+        free(asyncRequest->request);
+        free(asyncRequest->url);
+        free(asyncRequest);
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_sendLocal(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    char* wireId = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+    char* response = NULL;
+
+    // same replyStatus values as a request through the webserver would give
+    if (wiringReceiveRegistry_receive(sendService->admin->receiveRegistry, wireId, request, &response) != CELIX_SUCCESS) {
+        *replyStatus = 404;
+    } else if (response == NULL) {
+        *replyStatus = 204;
+    } else {
+        *replyStatus = 0;
+        *reply = response;
+    }
+
+    return status;
+}
+
+// receivers take NUL-terminated requests, so the length is of no use here
+static celix_status_t wiringAdmin_sendSizedLocal(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus) {
+    return wiringAdmin_sendLocal(sendService, request, reply, replyStatus);
+}
+
+static celix_status_t wiringAdmin_sendOnewayLocal(wiring_send_service_pt sendService, char *request) {
+    return wiringAdmin_sendAsyncLocal(sendService, request, NULL, NULL);
+}
+
+/*
+ * The stream is handed to a receiver of this framework directly. Receivers which cannot stream get
+ * the request collected, as they would through the webserver.
+ */
+static celix_status_t wiringAdmin_sendStreamLocal(wiring_send_service_pt sendService, wiring_stream_reader_pt request, wiring_stream_writer_pt reply, int* replyStatus) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    char* wireId = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+    struct stream_counter counter = { reply, 0 };
+    struct wiring_stream_writer writer = { &counter, wiringAdmin_streamCount };
+    celix_status_t receiveStatus = CELIX_SUCCESS;
+    bool streamed = false;
+
+    *replyStatus = 0;
+
+    if (wiringReceiveRegistry_receiveStream(sendService->admin->receiveRegistry, wireId, request, &writer, &streamed, &receiveStatus) != CELIX_SUCCESS) {
+        *replyStatus = 404;
+    } else if (streamed) {
+        if (receiveStatus != CELIX_SUCCESS) {
+            status = CELIX_ILLEGAL_STATE;
+        } else if (counter.written == 0) {
+            *replyStatus = 204;
+        }
+    } else {
+        wiring_buffer_pt buffer = NULL;
+        size_t length = 0;
+        char* response = NULL;
+
+        status = wiringBuffer_create(0, &buffer);
+
+        while (status == CELIX_SUCCESS) {
+            size_t available = buffer->capacity - buffer->size - 1;
+
+            if (available == 0) {
+                status = wiringBuffer_reserve(buffer, buffer->capacity * 2);
+            } else if (request->read(request->handle, &buffer->data[buffer->size], available, &length) != CELIX_SUCCESS) {
+                status = CELIX_FILE_IO_EXCEPTION;
+            } else if (length == 0) {
+                break;
+            } else {
+                buffer->size += length;
+                buffer->data[buffer->size] = '\0';
+            }
+        }
+
+        if (status == CELIX_SUCCESS) {
+            status = wiringAdmin_sendLocal(sendService, buffer->data, &response, replyStatus);
+        }
+
+        if (status == CELIX_SUCCESS && response != NULL && reply->write(reply->handle, response, strlen(response)) != CELIX_SUCCESS) {
+            status = CELIX_FILE_IO_EXCEPTION;
+        }
+
+        free(response);
+        wiringBuffer_destroy(buffer);
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_streamCount(void* handle, const char* data, size_t length) {
+    struct stream_counter* counter = handle;
+
+    counter->written += length;
+
+    return counter->writer->write(counter->writer->handle, data, length);
+}
+
+static celix_status_t wiringAdmin_sendBatchLocal(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses) {
+    celix_status_t status = CELIX_SUCCESS;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        replies[i] = NULL;
+        wiringAdmin_sendLocal(sendService, requests[i], &replies[i], &replyStatuses[i]);
+    }
+
+    return status;
+}
+
+/*
+ * Local asynchronous requests are handed to the receiver by a local async worker, never by the event
+ * loop thread, so a slow receiver does not hold up remote transfers. The callback is invoked from
+ * that worker, an admin thread like for remote wires.
+ */
+static celix_status_t wiringAdmin_sendAsyncLocal(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_admin_pt admin = sendService->admin;
+    char* wireId = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+
+    wiring_async_request_pt asyncRequest = calloc(1, sizeof(*asyncRequest));
+
+    if (!asyncRequest) {
+        status = CELIX_ENOMEM;
+    } else {
+        asyncRequest->admin = admin;
+        asyncRequest->callback = callback;
+        asyncRequest->userdata = userdata;
+        asyncRequest->wireId = strdup(wireId);
+        asyncRequest->request = strdup(request);
+
+        if (asyncRequest->wireId == NULL || asyncRequest->request == NULL) {
+            status = CELIX_ENOMEM;
+        } else {
+            celixThreadMutex_lock(&admin->asyncQueueLock);
+
+            if (admin->asyncRunning && admin->localAsyncWorkerCount > 0) {
+                arrayList_add(admin->localAsyncQueue, asyncRequest);
+                celixThreadCondition_signal(&admin->localAsyncQueued);
+            } else {
+                status = CELIX_ILLEGAL_STATE;
+            }
+
+            celixThreadMutex_unlock(&admin->asyncQueueLock);
+        }
+    }
+
+    if (status != CELIX_SUCCESS && asyncRequest != NULL) {
+        free(asyncRequest->request);
+        free(asyncRequest->wireId);
+        free(asyncRequest);
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_startAsync(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    admin->asyncWakeupPipe[0] = -1;
+    admin->asyncWakeupPipe[1] = -1;
+
+    arrayList_create(&admin->asyncQueue);
+    arrayList_create(&admin->asyncActive);
+    arrayList_create(&admin->localAsyncQueue);
+    celixThreadMutex_create(&admin->asyncQueueLock, NULL);
+    celixThreadCondition_init(&admin->localAsyncQueued, NULL);
+    admin->localAsyncWorkerCount = 0;
+
+    admin->asyncMulti = curl_multi_init();
+
+    if (admin->asyncMulti == NULL) {
+        status = CELIX_ILLEGAL_STATE;
+    } else if (pipe(admin->asyncWakeupPipe) != 0) {
+        admin->asyncWakeupPipe[0] = -1;
+        admin->asyncWakeupPipe[1] = -1;
+        status = CELIX_ILLEGAL_STATE;
+    } else {
+        fcntl(admin->asyncWakeupPipe[0], F_SETFL, fcntl(admin->asyncWakeupPipe[0], F_GETFL) | O_NONBLOCK);
+        fcntl(admin->asyncWakeupPipe[1], F_SETFL, fcntl(admin->asyncWakeupPipe[1], F_GETFL) | O_NONBLOCK);
+
+        admin->asyncRunning = true;
+
+        status = celixThread_create(&admin->asyncThread, NULL, wiringAdmin_asyncRun, admin);
+
+        if (status != CELIX_SUCCESS) {
+            admin->asyncRunning = false;
+        }
+    }
+
+    // fewer workers than configured only lower the parallelism of local requests
+    while (status == CELIX_SUCCESS && admin->localAsyncWorkerCount < WIRING_ADMIN_LOCAL_ASYNC_THREADS
+            && celixThread_create(&admin->localAsyncWorkers[admin->localAsyncWorkerCount], NULL, wiringAdmin_localAsyncRun, admin) == CELIX_SUCCESS) {
+        admin->localAsyncWorkerCount++;
+    }
+
+    if (status != CELIX_SUCCESS) {
+        printf("%s: Could not start async send event loop\n", TAG);
+    }
+
+    return status;
+}
+
+static void wiringAdmin_stopAsync(wiring_admin_pt admin) {
+    bool running = false;
+    int i;
+
+    celixThreadMutex_lock(&admin->asyncQueueLock);
+    running = admin->asyncRunning;
+    admin->asyncRunning = false;
+    celixThreadCondition_broadcast(&admin->localAsyncQueued);
+    celixThreadMutex_unlock(&admin->asyncQueueLock);
+
+    if (running) {
+        if (write(admin->asyncWakeupPipe[1], "", 1) < 0) {
+            // nothing to do
+        }
+
+        celixThread_join(admin->asyncThread, NULL);
+
+        for (i = 0; i < admin->localAsyncWorkerCount; i++) {
+            celixThread_join(admin->localAsyncWorkers[i], NULL);
+        }
+        admin->localAsyncWorkerCount = 0;
+
+        // the event loop is gone, so whatever is left can be failed from here
+        for (i = 0; i < arrayList_size(admin->asyncActive); i++) {
+            wiring_async_request_pt asyncRequest = arrayList_get(admin->asyncActive, i);
+
+            curl_multi_remove_handle(admin->asyncMulti, asyncRequest->curl);
+            wiringAdmin_asyncComplete(asyncRequest, CELIX_ILLEGAL_STATE, CURLE_OK);
+        }
+        arrayList_clear(admin->asyncActive);
+
+        for (i = 0; i < arrayList_size(admin->asyncQueue); i++) {
+            wiringAdmin_asyncComplete(arrayList_get(admin->asyncQueue, i), CELIX_ILLEGAL_STATE, CURLE_OK);
+        }
+        arrayList_clear(admin->asyncQueue);
+
+        for (i = 0; i < arrayList_size(admin->localAsyncQueue); i++) {
+            wiringAdmin_asyncComplete(arrayList_get(admin->localAsyncQueue, i), CELIX_ILLEGAL_STATE, CURLE_OK);
+        }
+        arrayList_clear(admin->localAsyncQueue);
+    }
+}
+
+static void* wiringAdmin_localAsyncRun(void* data) {
+    wiring_admin_pt admin = data;
+
+    celixThreadMutex_lock(&admin->asyncQueueLock);
+
+    while (admin->asyncRunning) {
+        if (arrayList_size(admin->localAsyncQueue) > 0) {
+            wiring_async_request_pt asyncRequest = arrayList_remove(admin->localAsyncQueue, 0);
+
+            celixThreadMutex_unlock(&admin->asyncQueueLock);
+            wiringAdmin_asyncComplete(asyncRequest, CELIX_SUCCESS, CURLE_OK);
+            celixThreadMutex_lock(&admin->asyncQueueLock);
+        } else {
+            celixThreadCondition_wait(&admin->localAsyncQueued, &admin->asyncQueueLock);
+        }
+    }
+
+    celixThreadMutex_unlock(&admin->asyncQueueLock);
+
+    return NULL;
+}
+
+static void* wiringAdmin_asyncRun(void* data) {
+    wiring_admin_pt admin = data;
+
+    while (admin->asyncRunning) {
+        int runningHandles = 0;
+        int numfds = 0;
+        int msgsInQueue = 0;
+        CURLMsg* msg = NULL;
+        struct curl_waitfd wakeup;
+        char drain[64];
+
+        celixThreadMutex_lock(&admin->asyncQueueLock);
+        while (arrayList_size(admin->asyncQueue) > 0) {
+            wiring_async_request_pt asyncRequest = arrayList_remove(admin->asyncQueue, 0);
+
+            if (curl_multi_add_handle(admin->asyncMulti, asyncRequest->curl) == CURLM_OK) {
+                arrayList_add(admin->asyncActive, asyncRequest);
+            } else {
+                celixThreadMutex_unlock(&admin->asyncQueueLock);
+                wiringAdmin_asyncComplete(asyncRequest, CELIX_ILLEGAL_STATE, CURLE_OK);
+                celixThreadMutex_lock(&admin->asyncQueueLock);
+            }
+        }
+        celixThreadMutex_unlock(&admin->asyncQueueLock);
+
+        curl_multi_perform(admin->asyncMulti, &runningHandles);
+
+        while ((msg = curl_multi_info_read(admin->asyncMulti, &msgsInQueue)) != NULL) {
+            if (msg->msg == CURLMSG_DONE) {
+                wiring_async_request_pt asyncRequest = NULL;
+                CURLcode res = msg->data.result;
+
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **) &asyncRequest);
+                curl_multi_remove_handle(admin->asyncMulti, msg->easy_handle);
+
+                arrayList_removeElement(admin->asyncActive, asyncRequest);
+                wiringAdmin_asyncComplete(asyncRequest, CELIX_SUCCESS, res);
+            }
+        }
+
+        wakeup.fd = admin->asyncWakeupPipe[0];
+        wakeup.events = CURL_WAIT_POLLIN;
+        wakeup.revents = 0;
+
+        curl_multi_wait(admin->asyncMulti, &wakeup, 1, WIRING_ADMIN_ASYNC_POLL_TIMEOUT, &numfds);
+
+        while (read(admin->asyncWakeupPipe[0], drain, sizeof(drain)) > 0) {
+            // pending wakeups are all handled by the next iteration
+        }
+    }
+
+    return NULL;
+}
+
+static void wiringAdmin_asyncComplete(wiring_async_request_pt asyncRequest, celix_status_t status, CURLcode res) {
+    char* reply = NULL;
+    int replyStatus = 0;
+
+    if (status == CELIX_SUCCESS && asyncRequest->wireId != NULL) {
+        if (wiringReceiveRegistry_receive(asyncRequest->admin->receiveRegistry, asyncRequest->wireId, asyncRequest->request, &reply) != CELIX_SUCCESS) {
+            replyStatus = 404;
+        } else if (reply == NULL) {
+            replyStatus = 204;
+        }
+    } else if (status == CELIX_SUCCESS) {
+        long http_code = 0;
+
+        curl_easy_getinfo(asyncRequest->curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+        if (asyncRequest->replyBuffer->status != CELIX_SUCCESS) {
+            status = asyncRequest->replyBuffer->status;
+        } else if (http_code == 200 && res != CURLE_ABORTED_BY_CALLBACK) {
+            replyStatus = res;
+            status = wiringBuffer_detach(asyncRequest->replyBuffer, &reply, NULL);
+        } else {
+            replyStatus = http_code;
+        }
+    }
+
+    if (asyncRequest->callback != NULL) {
+        asyncRequest->callback(asyncRequest->userdata, status, reply, replyStatus);
+    } else {
+        free(reply);
+    }
+
+    if (asyncRequest->curl != NULL) {
+        wiringAdmin_releaseCurlHandle(asyncRequest->admin, asyncRequest->url, asyncRequest->curl);
+    }
+    wiringBuffer_destroy(asyncRequest->replyBuffer);
+    free(asyncRequest->request);
+    free(asyncRequest->url);
+    free(asyncRequest->wireId);
+    free(asyncRequest);
+}
+
+/*
+ * curl handles are pooled per wire (keyed by url), so the HTTP connection
+ * of a handle is kept alive and reused by subsequent sends. Requests are
+ * passed with CURLOPT_POSTFIELDS, which lets curl send them again on a new
+ * connection when the receiver has closed the idle one.
+ */
+static celix_status_t wiringAdmin_getCurlHandle(wiring_admin_pt admin, char* url, CURL** curl) {
+    celix_status_t status = CELIX_SUCCESS;
+    curl_handle_pool_pt pool = NULL;
+
+    *curl = NULL;
+
+    celixThreadMutex_lock(&admin->curlHandlePoolsLock);
+
+    pool = hashMap_get(admin->curlHandlePools, url);
+
+    if (pool == NULL) {
+        pool = calloc(1, sizeof(*pool));
+
+        if (pool != NULL) {
+            arrayList_create(&pool->idleHandles);
+            hashMap_put(admin->curlHandlePools, strdup(url), pool);
+        }
+    }
+
+    if (pool != NULL) {
+        int size = arrayList_size(pool->idleHandles);
+        if (size > 0) {
+            *curl = arrayList_remove(pool->idleHandles, size - 1);
+        }
+    }
+
+    celixThreadMutex_unlock(&admin->curlHandlePoolsLock);
+
+    if (pool == NULL) {
+        status = CELIX_ENOMEM;
+    } else {
+        if (*curl == NULL) {
+            *curl = curl_easy_init();
+
+            if (*curl == NULL) {
+                status = CELIX_ILLEGAL_STATE;
+            } else {
+                curl_easy_setopt(*curl, CURLOPT_URL, url);
+                curl_easy_setopt(*curl, CURLOPT_POST, 1L);
+                curl_easy_setopt(*curl, CURLOPT_NOSIGNAL, 1L);
+                curl_easy_setopt(*curl, CURLOPT_TCP_KEEPALIVE, 1L);
+                curl_easy_setopt(*curl, CURLOPT_CONNECTTIMEOUT, 2L);
+                curl_easy_setopt(*curl, CURLOPT_TIMEOUT, 2L);
+            }
+        }
+    }
+
+    return status;
+}
+
+static void wiringAdmin_releaseCurlHandle(wiring_admin_pt admin, char* url, CURL* curl) {
+    curl_handle_pool_pt pool = NULL;
+
+    // the pool is gone when the wire was removed while the handle was in use
+    celixThreadMutex_lock(&admin->curlHandlePoolsLock);
+    pool = hashMap_get(admin->curlHandlePools, url);
+
+    if (pool != NULL && arrayList_size(pool->idleHandles) < MAX_POOLED_CURL_HANDLES) {
+        arrayList_add(pool->idleHandles, curl);
+        curl = NULL;
+    }
+
+    celixThreadMutex_unlock(&admin->curlHandlePoolsLock);
+
+    if (curl != NULL) {
+        curl_easy_cleanup(curl);
+    }
+}
+
+static void wiringAdmin_removeCurlHandlePool(wiring_admin_pt admin, char* url) {
+    curl_handle_pool_pt pool = NULL;
+    char* key = NULL;
+
+    celixThreadMutex_lock(&admin->curlHandlePoolsLock);
+    hash_map_entry_pt entry = hashMap_getEntry(admin->curlHandlePools, url);
+
+    if (entry != NULL) {
+        key = hashMapEntry_getKey(entry);
+        pool = hashMap_remove(admin->curlHandlePools, url);
+    }
+
+    celixThreadMutex_unlock(&admin->curlHandlePoolsLock);
+
+    if (pool != NULL) {
+        int i;
+
+        for (i = 0; i < arrayList_size(pool->idleHandles); i++) {
+            curl_easy_cleanup(arrayList_get(pool->idleHandles, i));
+        }
+
+        arrayList_destroy(pool->idleHandles);
+        free(pool);
+        free(key);
+    }
+}
+
+// trailers of a chunked reply are passed to this callback as well
+static size_t wiringAdmin_HTTPStreamHeaderCallback(char *buffer, size_t size, size_t nitems, void *userp) {
+    struct stream_transfer *transfer = userp;
+    size_t length = size * nitems;
+    char value[16];
+
+    if (wiringAdmin_getHeaderValue(buffer, length, WIRING_ADMIN_STREAM_STATUS_HEADER, value, sizeof(value))) {
+        transfer->receiveStatus = strtol(value, NULL, 10);
+    }
+
+    return length;
+}
+
+// copies the (possibly truncated) value if the header line is the named header
+static bool wiringAdmin_getHeaderValue(const char* buffer, size_t length, const char* name, char* value, size_t valueSize) {
+    size_t nameLength = strlen(name);
+    bool found = (length > nameLength && buffer[nameLength] == ':' && strncasecmp(buffer, name, nameLength) == 0);
+
+    if (found) {
+        size_t valueLength = length - nameLength - 1;
+
+        if (valueLength >= valueSize) {
+            valueLength = valueSize - 1;
+        }
+
+        memcpy(value, buffer + nameLength + 1, valueLength);
+        value[valueLength] = '\0';
+    }
+
+    return found;
+}
+
+static size_t wiringAdmin_HTTPStreamReadCallback(void *ptr, size_t size, size_t nmemb, void *userp) {
+    struct stream_transfer *transfer = userp;
+    size_t length = 0;
+
+    if (transfer->reader->read(transfer->reader->handle, ptr, size * nmemb, &length) != CELIX_SUCCESS) {
+        transfer->status = CELIX_FILE_IO_EXCEPTION;
+        length = CURL_READFUNC_ABORT;
+    }
+
+    return length;
+}
+
+// only the body of a successful reply is the reply of the receiver, error bodies are dropped
+static size_t wiringAdmin_HTTPStreamWriteCallback(void *contents, size_t size, size_t nmemb, void *userp) {
+    struct stream_transfer *transfer = userp;
+    size_t length = size * nmemb;
+    long http_code = 0;
+
+    curl_easy_getinfo(transfer->curl, CURLINFO_RESPONSE_CODE, &http_code);
+
+    if (http_code == 200 && transfer->writer->write(transfer->writer->handle, contents, length) != CELIX_SUCCESS) {
+        transfer->status = CELIX_FILE_IO_EXCEPTION;
+        length = 0;
+    }
+
+    return length;
+}
+
+// only wires whose exporter announced deflate get compressed requests
+static bool wiringAdmin_useCompression(wiring_send_service_pt sendService) {
+    char* compression = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_COMPRESSION_KEY);
+
+    return sendService->admin->compression && compression != NULL && strcmp(compression, WIRING_ADMIN_COMPRESSION_DEFLATE) == 0;
+}
+
+/*
+ * Compresses data into the zlib format HTTP calls "deflate". Fails if the result would not be
+ * smaller than the input, the data is then better sent as it is.
+ */
+static celix_status_t wiringAdmin_deflate(const char* data, size_t length, char** deflated, size_t* deflatedLength) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    uLongf bound = compressBound(length);
+
+    *deflated = malloc(bound);
+
+    if (*deflated == NULL) {
+        status = CELIX_ENOMEM;
+    } else if (compress2((Bytef*) *deflated, &bound, (const Bytef*) data, length, Z_BEST_SPEED) != Z_OK || bound >= length) {
+        free(*deflated);
+        *deflated = NULL;
+        status = CELIX_ILLEGAL_STATE;
+    } else {
+        *deflatedLength = bound;
+    }
+
+    return status;
+}
+
+// the inflated size is bounded by the configured maximum request size, or a default when there is none
+static celix_status_t wiringAdmin_inflate(wiring_admin_pt admin, const char* data, size_t length, char** inflated, size_t* inflatedLength) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    uint64_t maxInflatedSize = (admin->maxRequestSize > 0) ? admin->maxRequestSize : DEFAULT_WA_MAX_INFLATED_SIZE;
+    wiring_buffer_pt buffer = NULL;
+    z_stream stream;
+    int rc = Z_OK;
+
+    memset(&stream, 0, sizeof(stream));
+
+    status = wiringBuffer_create(length * 4, &buffer);
+
+    if (status == CELIX_SUCCESS && inflateInit(&stream) != Z_OK) {
+        status = CELIX_ENOMEM;
+    }
+
+    if (status == CELIX_SUCCESS) {
+        stream.next_in = (Bytef*) data;
+        stream.avail_in = length;
+
+        while (status == CELIX_SUCCESS && rc != Z_STREAM_END) {
+            size_t required = buffer->size + INFLATE_CHUNK_SIZE;
+
+            if (required >= buffer->capacity) {
+                status = wiringBuffer_reserve(buffer, (buffer->capacity * 2 > required) ? buffer->capacity * 2 : required);
+            }
+
+            if (status == CELIX_SUCCESS) {
+                stream.next_out = (Bytef*) &buffer->data[buffer->size];
+                stream.avail_out = INFLATE_CHUNK_SIZE;
+
+                rc = inflate(&stream, Z_NO_FLUSH);
+
+                if (rc != Z_OK && rc != Z_STREAM_END) {
+                    status = CELIX_ILLEGAL_ARGUMENT;
+                } else if (rc == Z_OK && stream.avail_in == 0 && stream.avail_out > 0) {
+                    // truncated input
+                    status = CELIX_ILLEGAL_ARGUMENT;
+                } else {
+                    buffer->size += INFLATE_CHUNK_SIZE - stream.avail_out;
+                    buffer->data[buffer->size] = '\0';
+
+                    if (buffer->size > maxInflatedSize) {
+                        status = CELIX_ILLEGAL_ARGUMENT;
+                    }
+                }
+            }
+        }
+
+        inflateEnd(&stream);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringBuffer_detach(buffer, inflated, inflatedLength);
+    }
+
+    wiringBuffer_destroy(buffer);
+
+    return status;
 }
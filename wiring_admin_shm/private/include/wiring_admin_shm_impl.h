@@ -0,0 +1,172 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef WIRING_ADMIN_SHM_IMPL_H_
+#define WIRING_ADMIN_SHM_IMPL_H_
+
+#include "remote_constants.h"
+#include "constants.h"
+#include "utils.h"
+#include "bundle_context.h"
+#include "bundle.h"
+#include "service_reference.h"
+#include "service_registration.h"
+#include "celix_threads.h"
+
+#include <stdint.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+#include "wiring_admin.h"
+#include "remote_service_admin_inaetics.h"
+#include "wiring_receive_registry.h"
+
+#define MAX_SHM_NAME_LENGTH 	64
+#define MAX_WIRE_ID_LENGTH 		64
+
+// framework properties of the shared memory wiring admin
+#define WIRING_ADMIN_SHM_SLOTS				"WIRING_ADMIN_SHM_SLOTS"
+#define WIRING_ADMIN_SHM_SLOT_SIZE			"WIRING_ADMIN_SHM_SLOT_SIZE"
+#define WIRING_ADMIN_SHM_NUM_THREADS		"WIRING_ADMIN_SHM_NUM_THREADS"
+#define WIRING_ADMIN_SHM_TIMEOUT_MS			"WIRING_ADMIN_SHM_TIMEOUT_MS"
+
+#define DEFAULT_WA_SHM_SLOTS				16
+#define DEFAULT_WA_SHM_SLOT_SIZE			(64 * 1024)
+#define DEFAULT_WA_SHM_NUM_THREADS			2
+#define DEFAULT_WA_SHM_TIMEOUT_MS			2000
+
+// threads performing the sendAsync calls of wires imported by this framework
+#define WIRING_ADMIN_SHM_ASYNC_THREADS		2
+
+#define WIRING_ADMIN_PROPERTIES_CONFIG_VALUE		WIRING_ADMIN_PROPERTIES_SHM_CONFIG_VALUE
+#define WIRING_ADMIN_PROPERTIES_SECURE_VALUE 		"no"
+
+#define TAG                                         "WIRING_ADMIN_SHM"
+
+#define WIRING_SHM_MAGIC					0x57534832 // "WSH2"
+#define WIRING_SHM_MAX_SLOTS				256
+#define WIRING_SHM_SLOT_ALIGNMENT			64
+
+// replyStatus of requests that were still queued when the exporter stopped
+#define WIRING_SHM_REPLY_UNAVAILABLE		-1
+
+typedef enum wiring_shm_slot_state {
+	WIRING_SHM_SLOT_FREE = 0,
+	WIRING_SHM_SLOT_CLAIMED,	// owned by a client that is filling in the request
+	WIRING_SHM_SLOT_POSTED,		// queued in the request ring
+	WIRING_SHM_SLOT_PROCESSING,	// owned by a server worker
+	WIRING_SHM_SLOT_REPLIED,	// owned by the client again, reply can be read
+	WIRING_SHM_SLOT_ABANDONED	// the client timed out, whoever finishes the slot frees it
+} wiring_shm_slot_state_t;
+
+/*
+ * Request/reply slot in the shared segment. The request is written to data by the client, the
+ * server overwrites it with the reply. Ownership is handed over by changing state under the
+ * segment lock, the data itself is copied without holding it. Nobody waits for the reply of a
+ * one-way slot, the server frees it once the request is handled.
+ */
+typedef struct wiring_shm_slot {
+	pthread_cond_t replied;
+	uint32_t state;
+	uint32_t oneway;
+	pid_t claimant; // process that claimed the slot, its slot is reclaimed if it dies
+
+	char wireId[MAX_WIRE_ID_LENGTH];
+	uint32_t requestLength;
+	uint32_t replyLength;
+	int32_t replyStatus;
+
+	char data[];
+} wiring_shm_slot_t;
+
+/*
+ * Layout of the shared memory segment of an exporting framework. The lock and conditions are
+ * process-shared (futex based on Linux) and the lock is robust, so a client dying while holding
+ * it does not block the exporter. Posted slots are queued in a ring of slot indices; free slots
+ * are kept on a stack.
+ */
+typedef struct wiring_shm_segment {
+	uint32_t magic;
+	uint32_t slotCount;
+	uint32_t slotSize; // size of the data area of a slot
+	volatile uint32_t serverRunning;
+
+	pthread_mutex_t lock;
+	pthread_cond_t requestPosted;
+	pthread_cond_t slotFreed;
+
+	uint32_t ringHead;
+	uint32_t ringTail;
+	uint32_t ring[WIRING_SHM_MAX_SLOTS];
+
+	uint32_t freeCount;
+	uint32_t freeSlots[WIRING_SHM_MAX_SLOTS];
+
+	char slots[];
+} wiring_shm_segment_t;
+
+// a segment mapped into this process, either our own or one of an exporter on this host
+typedef struct wiring_shm_mapping {
+	char name[MAX_SHM_NAME_LENGTH];
+	wiring_shm_segment_t* segment;
+	size_t size;
+	unsigned int refCount; // client side only, guarded by clientMappingsLock
+} * wiring_shm_mapping_pt;
+
+struct wiring_admin {
+	bundle_context_pt context;
+
+	celix_thread_mutex_t exportedWiringEndpointLock;
+	celix_thread_mutex_t importedWiringEndpointLock;
+
+	properties_pt adminProperties;
+
+	hash_map_pt wiringSendServices; //key=wiring_endpoint_desc,  value=services
+	hash_map_pt wiringSendRegistrations; //key=wiring_endpoint_desc,  value=serviceRegistrations
+	hash_map_pt wiringSendMappings; //key=wiring_endpoint_desc,  value=wiring_shm_mapping the import holds a reference on
+
+	wiring_receive_registry_pt receiveRegistry;
+	hash_map_pt sharedWiringEndpoints; //wiring_endpoint_descs owned by another admin, guarded by exportedWiringEndpointLock
+
+	char* hostId;
+	int timeout; //ms
+
+	// server side
+	wiring_shm_mapping_pt serverMapping;
+	int numWorkers;
+	celix_thread_t* workers;
+
+	// client side
+	celix_thread_mutex_t clientMappingsLock;
+	hash_map_pt clientMappings; //key=segment name, value=wiring_shm_mapping, a stopped admin forgets the mappings still in use
+
+	celix_thread_mutex_t asyncQueueLock;
+	celix_thread_cond_t asyncQueued;
+	array_list_pt asyncQueue; //guarded by asyncQueueLock
+	volatile bool asyncRunning;
+	celix_thread_t asyncWorkers[WIRING_ADMIN_SHM_ASYNC_THREADS];
+	int asyncWorkerCount;
+};
+
+// carries copies of the wire it is sent on, the send service may be gone before it is performed
+typedef struct wiring_shm_async_request {
+	char name[MAX_SHM_NAME_LENGTH];
+	char wireId[MAX_WIRE_ID_LENGTH];
+	char* request;
+	wiring_send_callback_pt callback;
+	void* userdata;
+}* wiring_shm_async_request_pt;
+
+celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *admin);
+celix_status_t wiringAdmin_destroy(wiring_admin_pt* admin);
+celix_status_t wiringAdmin_stop(wiring_admin_pt admin);
+
+celix_status_t wiringAdmin_exportWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt* wEndpointDescription);
+celix_status_t wiringAdmin_removeExportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription);
+celix_status_t wiringAdmin_getWiringAdminProperties(wiring_admin_pt admin, properties_pt *adminProperties);
+
+celix_status_t wiringAdmin_importWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription);
+celix_status_t wiringAdmin_removeImportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription);
+
+#endif /* WIRING_ADMIN_SHM_IMPL_H_ */
@@ -0,0 +1,1018 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <signal.h>
+#include <pthread.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <properties.h>
+
+#include "remote_service_admin.h"
+#include "remote_service_admin_inaetics.h"
+
+#include "wiring_admin.h"
+#include "wiring_admin_shm_impl.h"
+#include "wiring_common_utils.h"
+
+static volatile unsigned int wiringAdmin_segmentCounter = 0;
+
+static celix_status_t wiringAdmin_send(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendSized(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendAsync(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata);
+static celix_status_t wiringAdmin_sendBatch(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses);
+static celix_status_t wiringAdmin_sendOneway(wiring_send_service_pt sendService, char *request);
+static celix_status_t wiringAdmin_sendOnService(wiring_send_service_pt sendService, char *request, size_t requestLength, bool oneway, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_postRequest(wiring_admin_pt admin, char* name, char* wireId, char *request, size_t requestLength, bool oneway, char **reply, int* replyStatus);
+
+static celix_status_t wiringAdmin_startServer(wiring_admin_pt admin);
+static celix_status_t wiringAdmin_stopServer(wiring_admin_pt admin);
+static void* wiringAdmin_workerRun(void* data);
+
+static celix_status_t wiringAdmin_startAsync(wiring_admin_pt admin);
+static celix_status_t wiringAdmin_stopAsync(wiring_admin_pt admin);
+static void* wiringAdmin_asyncRun(void* data);
+
+static celix_status_t wiringAdmin_acquireMapping(wiring_admin_pt admin, char* name, wiring_shm_mapping_pt* mapping);
+static void wiringAdmin_releaseMapping(wiring_admin_pt admin, wiring_shm_mapping_pt mapping);
+
+static wiring_shm_slot_t* wiringAdmin_getSlot(wiring_shm_segment_t* segment, uint32_t index);
+static void wiringAdmin_freeSlot(wiring_shm_segment_t* segment, uint32_t index);
+static uint32_t wiringAdmin_reclaimSlots(wiring_shm_segment_t* segment);
+static int wiringAdmin_lockSegment(wiring_shm_segment_t* segment);
+static int wiringAdmin_waitSegment(wiring_shm_segment_t* segment, pthread_cond_t* cond, struct timespec* deadline);
+
+celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    *admin = calloc(1, sizeof(**admin));
+    if (!*admin) {
+        status = CELIX_ENOMEM;
+    } else {
+        char* timeout = NULL;
+
+        (*admin)->context = context;
+
+        bundleContext_getProperty(context, WIRING_ADMIN_SHM_TIMEOUT_MS, &timeout);
+        (*admin)->timeout = (timeout != NULL) ? atoi(timeout) : DEFAULT_WA_SHM_TIMEOUT_MS;
+
+        (*admin)->wiringSendServices = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
+        (*admin)->wiringSendRegistrations = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
+        (*admin)->wiringSendMappings = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
+        (*admin)->clientMappings = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+        (*admin)->sharedWiringEndpoints = hashMap_create(NULL, NULL, NULL, NULL);
+
+        arrayList_create(&(*admin)->asyncQueue);
+
+        (*admin)->adminProperties = properties_create();
+
+        properties_set((*admin)->adminProperties, WIRING_ADMIN_PROPERTIES_SECURE_KEY, WIRING_ADMIN_PROPERTIES_SECURE_VALUE);
+        properties_set((*admin)->adminProperties, WIRING_ADMIN_PROPERTIES_CONFIG_KEY, WIRING_ADMIN_PROPERTIES_CONFIG_VALUE);
+
+        celixThreadMutex_create(&(*admin)->exportedWiringEndpointLock, NULL);
+        celixThreadMutex_create(&(*admin)->importedWiringEndpointLock, NULL);
+        celixThreadMutex_create(&(*admin)->clientMappingsLock, NULL);
+        celixThreadMutex_create(&(*admin)->asyncQueueLock, NULL);
+        celixThreadCondition_init(&(*admin)->asyncQueued, NULL);
+
+        status = wiring_getHostId(&(*admin)->hostId);
+
+        if (status == CELIX_SUCCESS) {
+            status = wiringReceiveRegistry_create(context, TAG, &(*admin)->receiveRegistry);
+        }
+
+        if (status == CELIX_SUCCESS) {
+            status = wiringAdmin_startAsync(*admin);
+        }
+    }
+
+    return status;
+}
+
+celix_status_t wiringAdmin_getWiringAdminProperties(wiring_admin_pt admin, properties_pt *adminProperties) {
+
+    celix_status_t status = CELIX_SUCCESS;
+
+    *adminProperties = admin->adminProperties;
+
+    return status;
+
+}
+
+celix_status_t wiringAdmin_destroy(wiring_admin_pt* admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiringAdmin_stopAsync(*admin);
+    status = wiringAdmin_stopServer(*admin);
+
+    if ((*admin)->receiveRegistry != NULL) {
+        wiringReceiveRegistry_destroy(&(*admin)->receiveRegistry);
+    }
+
+    hashMap_destroy((*admin)->sharedWiringEndpoints, false, false);
+    celixThreadMutex_destroy(&((*admin)->exportedWiringEndpointLock));
+
+    celixThreadMutex_lock(&((*admin)->importedWiringEndpointLock));
+
+    // imports that were never removed still hold their mapping
+    hash_map_iterator_pt iter = hashMapIterator_create((*admin)->wiringSendMappings);
+    while (hashMapIterator_hasNext(iter)) {
+        wiringAdmin_releaseMapping(*admin, hashMapIterator_nextValue(iter));
+    }
+    hashMapIterator_destroy(iter);
+
+    hashMap_destroy((*admin)->wiringSendServices, false, false);
+    hashMap_destroy((*admin)->wiringSendRegistrations, false, false);
+    hashMap_destroy((*admin)->wiringSendMappings, false, false);
+    celixThreadMutex_unlock(&((*admin)->importedWiringEndpointLock));
+    celixThreadMutex_destroy(&((*admin)->importedWiringEndpointLock));
+
+    hashMap_destroy((*admin)->clientMappings, false, false);
+    celixThreadMutex_destroy(&((*admin)->clientMappingsLock));
+
+    arrayList_destroy((*admin)->asyncQueue);
+    celixThreadCondition_destroy(&((*admin)->asyncQueued));
+    celixThreadMutex_destroy(&((*admin)->asyncQueueLock));
+
+    properties_destroy((*admin)->adminProperties);
+
+    free((*admin)->hostId);
+    free(*admin);
+    *admin = NULL;
+
+    return status;
+}
+
+celix_status_t wiringAdmin_stop(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiringAdmin_stopAsync(admin);
+
+    celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
+
+    wiringReceiveRegistry_untrackAll(admin->receiveRegistry);
+    hashMap_clear(admin->sharedWiringEndpoints, false, false);
+    wiringAdmin_stopServer(admin);
+
+    celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
+
+    celixThreadMutex_lock(&admin->clientMappingsLock);
+
+    hash_map_iterator_pt iter = hashMapIterator_create(admin->clientMappings);
+
+    // sends still using a mapping keep it mapped, the last wiringAdmin_releaseMapping unmaps it
+    while (hashMapIterator_hasNext(iter)) {
+        wiring_shm_mapping_pt mapping = hashMapIterator_nextValue(iter);
+
+        if (mapping->refCount == 0) {
+            munmap(mapping->segment, mapping->size);
+            free(mapping);
+        }
+    }
+
+    hashMapIterator_destroy(iter);
+    hashMap_clear(admin->clientMappings, false, false);
+
+    celixThreadMutex_unlock(&admin->clientMappingsLock);
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_startServer(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    char* slotsProperty = NULL;
+    char* slotSizeProperty = NULL;
+    char* numThreads = NULL;
+    uint32_t slotCount = DEFAULT_WA_SHM_SLOTS;
+    uint32_t slotSize = DEFAULT_WA_SHM_SLOT_SIZE;
+    size_t size = 0;
+    int fd = -1;
+
+    bundleContext_getProperty(admin->context, WIRING_ADMIN_SHM_SLOTS, &slotsProperty);
+    if (slotsProperty != NULL) {
+        slotCount = atoi(slotsProperty);
+    }
+
+    if (slotCount < 1 || slotCount > WIRING_SHM_MAX_SLOTS) {
+        printf("%s: %s must be between 1 and %d, using %d\n", TAG, WIRING_ADMIN_SHM_SLOTS, WIRING_SHM_MAX_SLOTS, DEFAULT_WA_SHM_SLOTS);
+        slotCount = DEFAULT_WA_SHM_SLOTS;
+    }
+
+    bundleContext_getProperty(admin->context, WIRING_ADMIN_SHM_SLOT_SIZE, &slotSizeProperty);
+    if (slotSizeProperty != NULL && atoi(slotSizeProperty) > 0) {
+        slotSize = atoi(slotSizeProperty);
+    }
+
+    // keep every slot (and its process-shared condition) aligned
+    slotSize = (slotSize + WIRING_SHM_SLOT_ALIGNMENT - 1) & ~(WIRING_SHM_SLOT_ALIGNMENT - 1);
+    size = sizeof(wiring_shm_segment_t) + (size_t) slotCount * (sizeof(wiring_shm_slot_t) + slotSize);
+
+    admin->serverMapping = calloc(1, sizeof(*admin->serverMapping));
+
+    if (!admin->serverMapping) {
+        status = CELIX_ENOMEM;
+    } else {
+        snprintf(admin->serverMapping->name, MAX_SHM_NAME_LENGTH, "/inaetics_wiring_%d_%u", (int) getpid(), __sync_add_and_fetch(&wiringAdmin_segmentCounter, 1));
+
+        // only frameworks running as the same user can attach to the segment
+        fd = shm_open(admin->serverMapping->name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+
+        if (fd < 0 || ftruncate(fd, size) != 0) {
+            status = CELIX_FILE_IO_EXCEPTION;
+        } else {
+            admin->serverMapping->segment = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+            if (admin->serverMapping->segment == MAP_FAILED) {
+                admin->serverMapping->segment = NULL;
+                status = CELIX_FILE_IO_EXCEPTION;
+            } else {
+                admin->serverMapping->size = size;
+            }
+        }
+
+        if (fd >= 0) {
+            close(fd);
+        }
+
+        if (status != CELIX_SUCCESS) {
+            printf("%s: Could not create shared memory segment %s: %s\n", TAG, admin->serverMapping->name, strerror(errno));
+            shm_unlink(admin->serverMapping->name);
+            free(admin->serverMapping);
+            admin->serverMapping = NULL;
+        }
+    }
+
+    if (status == CELIX_SUCCESS) {
+        wiring_shm_segment_t* segment = admin->serverMapping->segment;
+        pthread_mutexattr_t mutexAttr;
+        pthread_condattr_t condAttr;
+        uint32_t i;
+
+        pthread_mutexattr_init(&mutexAttr);
+        pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+        pthread_condattr_init(&condAttr);
+        pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+
+        pthread_mutex_init(&segment->lock, &mutexAttr);
+        pthread_cond_init(&segment->requestPosted, &condAttr);
+        pthread_cond_init(&segment->slotFreed, &condAttr);
+
+        segment->slotCount = slotCount;
+        segment->slotSize = slotSize;
+        segment->ringHead = 0;
+        segment->ringTail = 0;
+        segment->freeCount = slotCount;
+
+        for (i = 0; i < slotCount; i++) {
+            wiring_shm_slot_t* slot = wiringAdmin_getSlot(segment, i);
+
+            pthread_cond_init(&slot->replied, &condAttr);
+            slot->state = WIRING_SHM_SLOT_FREE;
+            segment->freeSlots[i] = slotCount - 1 - i;
+        }
+
+        pthread_condattr_destroy(&condAttr);
+        pthread_mutexattr_destroy(&mutexAttr);
+
+        segment->serverRunning = 1;
+        __sync_synchronize();
+        // importers check the magic last, so they never see a half initialized segment
+        segment->magic = WIRING_SHM_MAGIC;
+
+        bundleContext_getProperty(admin->context, WIRING_ADMIN_SHM_NUM_THREADS, &numThreads);
+        admin->numWorkers = (numThreads != NULL) ? atoi(numThreads) : DEFAULT_WA_SHM_NUM_THREADS;
+
+        if (admin->numWorkers < 1) {
+            admin->numWorkers = 1;
+        }
+
+        admin->workers = calloc(admin->numWorkers, sizeof(celix_thread_t));
+
+        for (i = 0; i < (uint32_t) admin->numWorkers; i++) {
+            celixThread_create(&admin->workers[i], NULL, wiringAdmin_workerRun, admin);
+        }
+
+        printf("%s: Shared memory Wiring Endpoint %s with %u slots of %u bytes started\n", TAG, admin->serverMapping->name, slotCount, slotSize);
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_stopServer(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    if (admin->serverMapping != NULL) {
+        wiring_shm_segment_t* segment = admin->serverMapping->segment;
+        int i;
+
+        printf("%s: Stopping shared memory Wiring Endpoint %s ...\n", TAG, admin->serverMapping->name);
+
+        // importers cannot open the segment anymore, their existing mappings stay valid
+        shm_unlink(admin->serverMapping->name);
+
+        wiringAdmin_lockSegment(segment);
+        segment->serverRunning = 0;
+        pthread_cond_broadcast(&segment->requestPosted);
+        pthread_cond_broadcast(&segment->slotFreed);
+        pthread_mutex_unlock(&segment->lock);
+
+        for (i = 0; i < admin->numWorkers; i++) {
+            celixThread_join(admin->workers[i], NULL);
+        }
+
+        free(admin->workers);
+        admin->workers = NULL;
+        admin->numWorkers = 0;
+
+        // fail the requests that are still queued
+        wiringAdmin_lockSegment(segment);
+
+        while (segment->ringHead != segment->ringTail) {
+            uint32_t index = segment->ring[segment->ringHead % WIRING_SHM_MAX_SLOTS];
+            wiring_shm_slot_t* slot = wiringAdmin_getSlot(segment, index);
+
+            segment->ringHead++;
+
+            if (slot->state == WIRING_SHM_SLOT_ABANDONED || slot->oneway) {
+                wiringAdmin_freeSlot(segment, index);
+            } else {
+                slot->replyLength = 0;
+                slot->replyStatus = WIRING_SHM_REPLY_UNAVAILABLE;
+                slot->state = WIRING_SHM_SLOT_REPLIED;
+                pthread_cond_broadcast(&slot->replied);
+            }
+        }
+
+        pthread_mutex_unlock(&segment->lock);
+
+        munmap(segment, admin->serverMapping->size);
+        free(admin->serverMapping);
+        admin->serverMapping = NULL;
+    }
+
+    return status;
+}
+
+static void* wiringAdmin_workerRun(void* data) {
+    wiring_admin_pt admin = data;
+    wiring_shm_segment_t* segment = admin->serverMapping->segment;
+
+    while (true) {
+        wiring_shm_slot_t* slot = NULL;
+        uint32_t index = 0;
+
+        wiringAdmin_lockSegment(segment);
+
+        while (segment->serverRunning && segment->ringHead == segment->ringTail) {
+            wiringAdmin_waitSegment(segment, &segment->requestPosted, NULL);
+        }
+
+        if (segment->serverRunning) {
+            index = segment->ring[segment->ringHead % WIRING_SHM_MAX_SLOTS];
+            segment->ringHead++;
+
+            slot = wiringAdmin_getSlot(segment, index);
+
+            if (slot->state == WIRING_SHM_SLOT_ABANDONED) {
+                wiringAdmin_freeSlot(segment, index);
+                slot = NULL;
+            } else {
+                slot->state = WIRING_SHM_SLOT_PROCESSING;
+            }
+        }
+
+        bool running = segment->serverRunning;
+
+        pthread_mutex_unlock(&segment->lock);
+
+        if (!running) {
+            break;
+        } else if (slot != NULL) {
+            char wireId[MAX_WIRE_ID_LENGTH];
+            char* response = NULL;
+            celix_status_t receiveStatus = CELIX_SUCCESS;
+
+            // the slot is written by another process, do not trust its lengths
+            memcpy(wireId, slot->wireId, MAX_WIRE_ID_LENGTH);
+            wireId[MAX_WIRE_ID_LENGTH - 1] = '\0';
+
+            if (slot->requestLength >= segment->slotSize) {
+                slot->requestLength = segment->slotSize - 1;
+            }
+            slot->data[slot->requestLength] = '\0';
+
+            slot->replyLength = 0;
+            slot->replyStatus = 404;
+
+            // the request is handed over in place, the reply only overwrites it after receive returns
+            receiveStatus = wiringReceiveRegistry_receive(admin->receiveRegistry, wireId, slot->data, &response);
+
+            if (receiveStatus == CELIX_SUCCESS) {
+                if (response == NULL) {
+                    slot->replyStatus = 204;
+                } else {
+                    size_t responseLength = strlen(response);
+
+                    if (responseLength >= segment->slotSize) {
+                        printf("%s: Reply of %zu bytes for wire %s does not fit into a slot\n", TAG, responseLength, wireId);
+                        slot->replyStatus = 413;
+                    } else {
+                        memcpy(slot->data, response, responseLength + 1);
+                        slot->replyLength = responseLength;
+                        slot->replyStatus = 0;
+                    }
+
+                    free(response);
+                }
+            }
+
+            wiringAdmin_lockSegment(segment);
+
+            if (slot->state == WIRING_SHM_SLOT_ABANDONED || slot->oneway) {
+                wiringAdmin_freeSlot(segment, index);
+            } else {
+                slot->state = WIRING_SHM_SLOT_REPLIED;
+                pthread_cond_broadcast(&slot->replied);
+            }
+
+            pthread_mutex_unlock(&segment->lock);
+        }
+    }
+
+    return NULL;
+}
+
+static celix_status_t wiringAdmin_startAsync(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    admin->asyncRunning = true;
+    admin->asyncWorkerCount = 0;
+
+    while (admin->asyncWorkerCount < WIRING_ADMIN_SHM_ASYNC_THREADS
+            && celixThread_create(&admin->asyncWorkers[admin->asyncWorkerCount], NULL, wiringAdmin_asyncRun, admin) == CELIX_SUCCESS) {
+        admin->asyncWorkerCount++;
+    }
+
+    if (admin->asyncWorkerCount == 0) {
+        admin->asyncRunning = false;
+        status = CELIX_BUNDLE_EXCEPTION;
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_stopAsync(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+    int i;
+
+    celixThreadMutex_lock(&admin->asyncQueueLock);
+    admin->asyncRunning = false;
+    celixThreadCondition_broadcast(&admin->asyncQueued);
+    celixThreadMutex_unlock(&admin->asyncQueueLock);
+
+    for (i = 0; i < admin->asyncWorkerCount; i++) {
+        celixThread_join(admin->asyncWorkers[i], NULL);
+    }
+
+    admin->asyncWorkerCount = 0;
+
+    return status;
+}
+
+static void* wiringAdmin_asyncRun(void* data) {
+    wiring_admin_pt admin = data;
+    bool running = true;
+
+    while (running) {
+        wiring_shm_async_request_pt asyncRequest = NULL;
+
+        celixThreadMutex_lock(&admin->asyncQueueLock);
+
+        while (admin->asyncRunning && arrayList_size(admin->asyncQueue) == 0) {
+            celixThreadCondition_wait(&admin->asyncQueued, &admin->asyncQueueLock);
+        }
+
+        if (arrayList_size(admin->asyncQueue) > 0) {
+            asyncRequest = arrayList_remove(admin->asyncQueue, 0);
+        } else {
+            running = false;
+        }
+
+        celixThreadMutex_unlock(&admin->asyncQueueLock);
+
+        if (asyncRequest != NULL) {
+            char* reply = NULL;
+            int replyStatus = 0;
+            celix_status_t status = CELIX_ILLEGAL_STATE;
+
+            // requests queued before the admin stopped are still completed, but not sent
+            if (admin->asyncRunning) {
+                status = wiringAdmin_postRequest(admin, asyncRequest->name, asyncRequest->wireId, asyncRequest->request, strlen(asyncRequest->request), false, &reply, &replyStatus);
+            }
+
+            asyncRequest->callback(asyncRequest->userdata, status, reply, replyStatus);
+
+            free(asyncRequest->request);
+            free(asyncRequest);
+        }
+    }
+
+    return NULL;
+}
+
+// a description passed in belongs to a wire of another admin, see wiring_admin_service
+celix_status_t wiringAdmin_exportWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt* wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    bool shared = (*wEndpointDescription != NULL);
+
+    celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
+
+    if (admin->serverMapping == NULL) {
+        status = wiringAdmin_startServer(admin);
+    }
+
+    if (status == CELIX_SUCCESS && !shared) {
+        status = wiringReceiveRegistry_createEndpoint(admin->receiveRegistry, WIRING_ADMIN_PROPERTIES_CONFIG_VALUE, wEndpointDescription);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringReceiveRegistry_track(admin->receiveRegistry, *wEndpointDescription);
+
+        // importers only see the segment of a wire that is served
+        if (status == CELIX_SUCCESS) {
+            properties_set((*wEndpointDescription)->properties, WIRING_ENDPOINT_DESCRIPTION_SHM_NAME_KEY, admin->serverMapping->name);
+            properties_set((*wEndpointDescription)->properties, WIRING_ENDPOINT_DESCRIPTION_HOST_ID_KEY, admin->hostId);
+
+            if (shared) {
+                hashMap_put(admin->sharedWiringEndpoints, *wEndpointDescription, *wEndpointDescription);
+            }
+        } else if (!shared) {
+            wiringEndpointDescription_destroy(wEndpointDescription);
+        }
+    } else {
+        printf("%s: Cannot export Wiring Endpoint\n", TAG);
+    }
+
+    if (wiringReceiveRegistry_getTrackedCount(admin->receiveRegistry) == 0) {
+        wiringAdmin_stopServer(admin);
+    }
+
+    celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
+
+    return status;
+}
+
+celix_status_t wiringAdmin_removeExportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    if (wEndpointDescription == NULL) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else {
+        celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
+
+        bool shared = (hashMap_remove(admin->sharedWiringEndpoints, wEndpointDescription) != NULL);
+
+        if (wiringReceiveRegistry_untrack(admin->receiveRegistry, wEndpointDescription) == CELIX_SUCCESS
+                && wiringReceiveRegistry_getTrackedCount(admin->receiveRegistry) == 0) {
+            wiringAdmin_stopServer(admin);
+        }
+
+        // the owning admin frees the description of a shared wire
+        if (!shared) {
+            wiringEndpointDescription_destroy(&wEndpointDescription);
+        }
+
+        celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
+    }
+
+    return status;
+}
+
+celix_status_t wiringAdmin_importWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    char* wireId = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+    char* name = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_SHM_NAME_KEY);
+    char* hostId = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_HOST_ID_KEY);
+    wiring_shm_mapping_pt mapping = NULL;
+
+    if (name == NULL || hostId == NULL) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else if (strcmp(hostId, admin->hostId) != 0) {
+        printf("%s: Wiring Endpoint w/ wireId %s runs on host %s, cannot import it on %s\n", TAG, wireId, hostId, admin->hostId);
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else {
+        status = wiringAdmin_acquireMapping(admin, name, &mapping);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        wiring_send_service_pt wiringSendService = calloc(1, sizeof(*wiringSendService));
+
+        if (!wiringSendService) {
+            wiringAdmin_releaseMapping(admin, mapping);
+            status = CELIX_ENOMEM;
+        } else {
+            service_registration_pt wiringSendServiceReg = NULL;
+
+            wiringSendService->wiringEndpointDescription = wEndpointDescription;
+            wiringSendService->send = wiringAdmin_send;
+            wiringSendService->sendSized = wiringAdmin_sendSized;
+            wiringSendService->sendAsync = wiringAdmin_sendAsync;
+            wiringSendService->sendBatch = wiringAdmin_sendBatch;
+            wiringSendService->sendOneway = wiringAdmin_sendOneway;
+            // no streaming, a request has to fit into a single slot
+            wiringSendService->sendStream = NULL;
+            wiringSendService->admin = admin;
+
+            celixThreadMutex_lock(&admin->importedWiringEndpointLock);
+
+            status = wiring_registerSendService(admin->context, TAG, wiringSendService, &wiringSendServiceReg);
+
+            if (status == CELIX_SUCCESS) {
+                hashMap_put(admin->wiringSendServices, wEndpointDescription, wiringSendService);
+                hashMap_put(admin->wiringSendRegistrations, wEndpointDescription, wiringSendServiceReg);
+                hashMap_put(admin->wiringSendMappings, wEndpointDescription, mapping);
+            } else {
+                wiringAdmin_releaseMapping(admin, mapping);
+                free(wiringSendService);
+            }
+
+            celixThreadMutex_unlock(&admin->importedWiringEndpointLock);
+        }
+    }
+
+    return status;
+}
+
+celix_status_t wiringAdmin_removeImportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    celixThreadMutex_lock(&admin->importedWiringEndpointLock);
+    char* wireId = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+
+    printf("%s: remove Wiring Endpoint w/ wireId %s\n", TAG, wireId);
+
+    wiring_send_service_pt wiringSendService = hashMap_remove(admin->wiringSendServices, wEndpointDescription);
+    service_registration_pt wiringSendRegistration = hashMap_remove(admin->wiringSendRegistrations, wEndpointDescription);
+
+    status = serviceRegistration_unregister(wiringSendRegistration);
+
+    if (status == CELIX_SUCCESS) {
+        free(wiringSendService);
+
+        // not looked up by name, the admin may have been stopped and the name mapped anew since
+        wiring_shm_mapping_pt mapping = hashMap_remove(admin->wiringSendMappings, wEndpointDescription);
+
+        if (mapping != NULL) {
+            wiringAdmin_releaseMapping(admin, mapping);
+        }
+    }
+
+    celixThreadMutex_unlock(&admin->importedWiringEndpointLock);
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_send(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus) {
+    return wiringAdmin_sendOnService(sendService, request, strlen(request), false, reply, replyStatus);
+}
+
+static celix_status_t wiringAdmin_sendSized(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus) {
+    return wiringAdmin_sendOnService(sendService, request, requestLength, false, reply, replyStatus);
+}
+
+// returns once the request is posted to the exporter's ring
+static celix_status_t wiringAdmin_sendOneway(wiring_send_service_pt sendService, char *request) {
+    return wiringAdmin_sendOnService(sendService, request, strlen(request), true, NULL, NULL);
+}
+
+static celix_status_t wiringAdmin_sendOnService(wiring_send_service_pt sendService, char *request, size_t requestLength, bool oneway, char **reply, int* replyStatus) {
+    char* name = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_SHM_NAME_KEY);
+    char* wireId = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+
+    return wiringAdmin_postRequest(sendService->admin, name, wireId, request, requestLength, oneway, reply, replyStatus);
+}
+
+static celix_status_t wiringAdmin_postRequest(wiring_admin_pt admin, char* name, char* wireId, char *request, size_t requestLength, bool oneway, char **reply, int* replyStatus) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_shm_mapping_pt mapping = NULL;
+    wiring_shm_segment_t* segment = NULL;
+
+    status = wiringAdmin_acquireMapping(admin, name, &mapping);
+
+    if (status == CELIX_SUCCESS) {
+        segment = mapping->segment;
+
+        if (requestLength >= segment->slotSize || strlen(wireId) >= MAX_WIRE_ID_LENGTH) {
+            printf("%s: Request of %zu bytes for wire %s does not fit into a slot\n", TAG, requestLength, wireId);
+            status = CELIX_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    if (status == CELIX_SUCCESS) {
+        struct timespec deadline;
+        wiring_shm_slot_t* slot = NULL;
+        uint32_t index = 0;
+        int rc = 0;
+
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += admin->timeout / 1000;
+        deadline.tv_nsec += (admin->timeout % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        wiringAdmin_lockSegment(segment);
+
+        while (segment->serverRunning && segment->freeCount == 0 && rc == 0) {
+            if (wiringAdmin_reclaimSlots(segment) == 0) {
+                rc = wiringAdmin_waitSegment(segment, &segment->slotFreed, &deadline);
+            }
+        }
+
+        if (!segment->serverRunning || segment->freeCount == 0) {
+            status = CELIX_ILLEGAL_STATE;
+        } else {
+            index = segment->freeSlots[--segment->freeCount];
+            slot = wiringAdmin_getSlot(segment, index);
+            slot->state = WIRING_SHM_SLOT_CLAIMED;
+            slot->claimant = getpid();
+        }
+
+        pthread_mutex_unlock(&segment->lock);
+
+        if (status == CELIX_SUCCESS) {
+            // the slot is ours until it is posted, so it is filled in without holding the lock
+            strncpy(slot->wireId, wireId, MAX_WIRE_ID_LENGTH);
+            memcpy(slot->data, request, requestLength + 1);
+            slot->requestLength = requestLength;
+            slot->oneway = oneway;
+
+            wiringAdmin_lockSegment(segment);
+
+            if (!segment->serverRunning) {
+                wiringAdmin_freeSlot(segment, index);
+                status = CELIX_ILLEGAL_STATE;
+            } else {
+                slot->state = WIRING_SHM_SLOT_POSTED;
+                segment->ring[segment->ringTail % WIRING_SHM_MAX_SLOTS] = index;
+                segment->ringTail++;
+                pthread_cond_signal(&segment->requestPosted);
+
+                // a posted one-way slot belongs to the exporter and must not be touched anymore
+                while (!oneway && slot->state != WIRING_SHM_SLOT_REPLIED && rc == 0) {
+                    rc = wiringAdmin_waitSegment(segment, &slot->replied, &deadline);
+                }
+
+                if (!oneway && slot->state != WIRING_SHM_SLOT_REPLIED) {
+                    // the exporter frees the slot once it is done with it
+                    slot->state = WIRING_SHM_SLOT_ABANDONED;
+                    status = CELIX_ILLEGAL_STATE;
+                    *replyStatus = ETIMEDOUT;
+                }
+            }
+
+            pthread_mutex_unlock(&segment->lock);
+        }
+
+        if (status == CELIX_SUCCESS && !oneway) {
+            // a replied slot belongs to us again, so the reply is copied without holding the lock
+            if (slot->replyStatus == WIRING_SHM_REPLY_UNAVAILABLE) {
+                status = CELIX_ILLEGAL_STATE;
+            } else if (slot->replyStatus == 0 && slot->replyLength < segment->slotSize) {
+                *reply = malloc(slot->replyLength + 1);
+
+                if (*reply == NULL) {
+                    status = CELIX_ENOMEM;
+                } else {
+                    memcpy(*reply, slot->data, slot->replyLength);
+                    (*reply)[slot->replyLength] = '\0';
+                    *replyStatus = 0;
+                }
+            } else {
+                *replyStatus = slot->replyStatus;
+            }
+
+            wiringAdmin_lockSegment(segment);
+            wiringAdmin_freeSlot(segment, index);
+            pthread_mutex_unlock(&segment->lock);
+        }
+    }
+
+    if (mapping != NULL) {
+        wiringAdmin_releaseMapping(admin, mapping);
+    }
+
+    return status;
+}
+
+/*
+ * A request already costs no more than a slot hand-over here, so a batch is sent request by
+ * request. The first failing transfer ends the batch.
+ */
+static celix_status_t wiringAdmin_sendBatch(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses) {
+    celix_status_t status = CELIX_SUCCESS;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        replies[i] = NULL;
+        replyStatuses[i] = 0;
+    }
+
+    for (i = 0; status == CELIX_SUCCESS && i < count; i++) {
+        status = wiringAdmin_send(sendService, requests[i], &replies[i], &replyStatuses[i]);
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_sendAsync(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_admin_pt admin = sendService->admin;
+    char* name = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_SHM_NAME_KEY);
+    char* wireId = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+    wiring_shm_async_request_pt asyncRequest = NULL;
+
+    if (name == NULL || wireId == NULL || strlen(name) >= MAX_SHM_NAME_LENGTH || strlen(wireId) >= MAX_WIRE_ID_LENGTH) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else if (!(asyncRequest = calloc(1, sizeof(*asyncRequest))) || !(asyncRequest->request = strdup(request))) {
+        free(asyncRequest);
+        status = CELIX_ENOMEM;
+    } else {
+        strcpy(asyncRequest->name, name);
+        strcpy(asyncRequest->wireId, wireId);
+        asyncRequest->callback = callback;
+        asyncRequest->userdata = userdata;
+
+        celixThreadMutex_lock(&admin->asyncQueueLock);
+
+        if (admin->asyncRunning) {
+            arrayList_add(admin->asyncQueue, asyncRequest);
+            celixThreadCondition_signal(&admin->asyncQueued);
+        } else {
+            status = CELIX_ILLEGAL_STATE;
+        }
+
+        celixThreadMutex_unlock(&admin->asyncQueueLock);
+
+        if (status != CELIX_SUCCESS) {
+            free(asyncRequest->request);
+            free(asyncRequest);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * Maps the segment of an exporter on this host, or takes another reference on an existing
+ * mapping. Mappings are shared by all wires of the same exporting framework.
+ */
+static celix_status_t wiringAdmin_acquireMapping(wiring_admin_pt admin, char* name, wiring_shm_mapping_pt* mapping) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    celixThreadMutex_lock(&admin->clientMappingsLock);
+
+    *mapping = hashMap_get(admin->clientMappings, name);
+
+    if (*mapping == NULL) {
+        int fd = shm_open(name, O_RDWR, 0);
+        struct stat st;
+
+        if (fd < 0 || fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(wiring_shm_segment_t)) {
+            printf("%s: Could not open shared memory segment %s\n", TAG, name);
+            status = CELIX_FILE_IO_EXCEPTION;
+        } else {
+            *mapping = calloc(1, sizeof(**mapping));
+
+            if (!*mapping) {
+                status = CELIX_ENOMEM;
+            } else {
+                (*mapping)->size = st.st_size;
+                (*mapping)->segment = mmap(NULL, (*mapping)->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                snprintf((*mapping)->name, MAX_SHM_NAME_LENGTH, "%s", name);
+
+                if ((*mapping)->segment == MAP_FAILED) {
+                    status = CELIX_FILE_IO_EXCEPTION;
+                } else {
+                    wiring_shm_segment_t* segment = (*mapping)->segment;
+
+                    if (segment->magic != WIRING_SHM_MAGIC || segment->slotCount > WIRING_SHM_MAX_SLOTS ||
+                            sizeof(wiring_shm_segment_t) + (size_t) segment->slotCount * (sizeof(wiring_shm_slot_t) + segment->slotSize) > (*mapping)->size) {
+                        printf("%s: %s is not a valid wiring segment\n", TAG, name);
+                        munmap(segment, (*mapping)->size);
+                        status = CELIX_ILLEGAL_STATE;
+                    }
+                }
+
+                if (status != CELIX_SUCCESS) {
+                    free(*mapping);
+                    *mapping = NULL;
+                } else {
+                    hashMap_put(admin->clientMappings, (*mapping)->name, *mapping);
+                }
+            }
+        }
+
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    if (*mapping != NULL) {
+        (*mapping)->refCount++;
+    }
+
+    celixThreadMutex_unlock(&admin->clientMappingsLock);
+
+    return status;
+}
+
+static void wiringAdmin_releaseMapping(wiring_admin_pt admin, wiring_shm_mapping_pt mapping) {
+    celixThreadMutex_lock(&admin->clientMappingsLock);
+
+    if (--mapping->refCount == 0) {
+        // a stopped admin has forgotten the mapping, the name may belong to a newer one by now
+        if (hashMap_get(admin->clientMappings, mapping->name) == mapping) {
+            hashMap_remove(admin->clientMappings, mapping->name);
+        }
+
+        munmap(mapping->segment, mapping->size);
+        free(mapping);
+    }
+
+    celixThreadMutex_unlock(&admin->clientMappingsLock);
+}
+
+static wiring_shm_slot_t* wiringAdmin_getSlot(wiring_shm_segment_t* segment, uint32_t index) {
+    return (wiring_shm_slot_t*) (segment->slots + (size_t) index * (sizeof(wiring_shm_slot_t) + segment->slotSize));
+}
+
+// caller holds the segment lock
+static void wiringAdmin_freeSlot(wiring_shm_segment_t* segment, uint32_t index) {
+    wiring_shm_slot_t* slot = wiringAdmin_getSlot(segment, index);
+
+    slot->state = WIRING_SHM_SLOT_FREE;
+    slot->claimant = 0;
+    segment->freeSlots[segment->freeCount++] = index;
+    pthread_cond_signal(&segment->slotFreed);
+}
+
+/*
+ * Frees the slots owned by clients that died before handing them back, nobody else ever would.
+ * A slot is the client's while it is claimed or replied. Caller holds the segment lock.
+ */
+static uint32_t wiringAdmin_reclaimSlots(wiring_shm_segment_t* segment) {
+    uint32_t reclaimed = 0;
+    uint32_t i;
+
+    for (i = 0; i < segment->slotCount; i++) {
+        wiring_shm_slot_t* slot = wiringAdmin_getSlot(segment, i);
+
+        if ((slot->state == WIRING_SHM_SLOT_CLAIMED || slot->state == WIRING_SHM_SLOT_REPLIED) && slot->claimant > 0
+                && kill(slot->claimant, 0) != 0 && errno == ESRCH) {
+            printf("%s: Reclaiming slot %u of process %d, which is gone\n", TAG, i, (int) slot->claimant);
+            wiringAdmin_freeSlot(segment, i);
+            reclaimed++;
+        }
+    }
+
+    return reclaimed;
+}
+
+// the segment lock is robust: the owner may have died in another process
+static int wiringAdmin_lockSegment(wiring_shm_segment_t* segment) {
+    int rc = pthread_mutex_lock(&segment->lock);
+
+    if (rc == EOWNERDEAD) {
+        printf("%s: Previous owner of the segment lock died, recovering\n", TAG);
+        rc = pthread_mutex_consistent(&segment->lock);
+    }
+
+    return rc;
+}
+
+static int wiringAdmin_waitSegment(wiring_shm_segment_t* segment, pthread_cond_t* cond, struct timespec* deadline) {
+    int rc = (deadline != NULL) ? pthread_cond_timedwait(cond, &segment->lock, deadline) : pthread_cond_wait(cond, &segment->lock);
+
+    if (rc == EOWNERDEAD) {
+        rc = pthread_mutex_consistent(&segment->lock);
+    }
+
+    return rc;
+}
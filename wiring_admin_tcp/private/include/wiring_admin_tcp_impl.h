@@ -0,0 +1,159 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef WIRING_ADMIN_TCP_IMPL_H_
+#define WIRING_ADMIN_TCP_IMPL_H_
+
+#include "remote_constants.h"
+#include "constants.h"
+#include "utils.h"
+#include "bundle_context.h"
+#include "bundle.h"
+#include "service_reference.h"
+#include "service_registration.h"
+#include "celix_threads.h"
+
+#include <stdint.h>
+#include <time.h>
+
+#include "wiring_admin.h"
+#include "remote_service_admin_inaetics.h"
+#include "wiring_receive_registry.h"
+
+#define MAX_URL_LENGTH 			128
+
+// framework properties of the tcp wiring admin, the address is taken from NODE_DISCOVERY_NODE_WA_ADDRESS/ITF
+#define WIRING_ADMIN_TCP_PORT				"WIRING_ADMIN_TCP_PORT"
+#define WIRING_ADMIN_TCP_NUM_THREADS		"WIRING_ADMIN_TCP_NUM_THREADS"
+#define WIRING_ADMIN_TCP_TIMEOUT_MS			"WIRING_ADMIN_TCP_TIMEOUT_MS"
+
+#define DEFAULT_WA_TCP_PORT					"6790"
+#define DEFAULT_WA_TCP_THREADS_PER_CPU		2
+#define DEFAULT_WA_TCP_TIMEOUT_MS			2000
+
+// how often (in ms) client readers look for asynchronous calls past their deadline
+#define WIRING_TCP_SWEEP_INTERVAL_MS		100
+
+#define WIRING_ADMIN_PROPERTIES_CONFIG_VALUE		"inaetics.wiring.tcp"
+#define WIRING_ADMIN_PROPERTIES_SECURE_VALUE 		"no"
+
+#define TAG                                         "WIRING_ADMIN_TCP"
+
+/*
+ * Every message is a frame of a fixed header followed by the wire id and the payload:
+ *
+ *   uint32 requestId | uint16 type | uint16 wireIdLength | uint32 payloadLength
+ *
+ * All header fields are in network byte order. Replies carry the requestId of their request
+ * and no wire id, so a connection can have any number of requests in flight. A batch frame carries
+ * several requests for one wire (see wiring_batch.h); it is answered with a reply frame holding the
+ * batch of replies, or with a malformed frame when the batch cannot be decoded. One-way frames are
+ * never answered.
+ */
+#define WIRING_TCP_HEADER_SIZE				12
+#define WIRING_TCP_MAX_PAYLOAD_LENGTH		(64 * 1024 * 1024)
+
+typedef enum wiring_tcp_frame_type {
+	WIRING_TCP_FRAME_REQUEST = 1,
+	WIRING_TCP_FRAME_REPLY = 2,
+	WIRING_TCP_FRAME_NO_REPLY = 3,
+	WIRING_TCP_FRAME_UNKNOWN_WIRE = 4,
+	WIRING_TCP_FRAME_BATCH = 5,
+	WIRING_TCP_FRAME_ONEWAY = 6,
+	WIRING_TCP_FRAME_MALFORMED = 7
+} wiring_tcp_frame_type_t;
+
+struct wiring_admin {
+	bundle_context_pt context;
+
+	celix_thread_mutex_t exportedWiringEndpointLock;
+	celix_thread_mutex_t importedWiringEndpointLock;
+
+	properties_pt adminProperties;
+
+	hash_map_pt wiringSendServices; //key=wiring_endpoint_desc,  value=services
+	hash_map_pt wiringSendRegistrations; //key=wiring_endpoint_desc,  value=serviceRegistrations
+
+	wiring_receive_registry_pt receiveRegistry;
+
+	int timeout; //ms
+
+	// server side
+	char url[MAX_URL_LENGTH];
+	int serverSocket;
+	volatile bool serverRunning;
+	celix_thread_t acceptThread;
+
+	celix_thread_mutex_t serverConnectionsLock;
+	celix_thread_cond_t serverConnectionsClosed;
+	array_list_pt serverConnections;
+
+	celix_thread_mutex_t requestQueueLock;
+	celix_thread_cond_t requestQueued;
+	array_list_pt requestQueue;
+	volatile bool workersRunning;
+	int numWorkers;
+	celix_thread_t* workers;
+
+	// client side, a connection lock may be held while taking clientReadersLock but not clientConnectionsLock
+	celix_thread_mutex_t clientConnectionsLock;
+	hash_map_pt clientConnections; //key=address, value=wiring_tcp_connection
+	celix_thread_mutex_t clientReadersLock;
+	celix_thread_cond_t clientReadersStopped;
+	int activeClientReaders;
+};
+
+/*
+ * A socket plus the state needed to multiplex requests over it. Server side connections are
+ * reference counted by their reader and by the queued requests; the socket is closed with the last
+ * reference. Client side connections are referenced by the clientConnections map, their reader and
+ * the calls using them. They reconnect on demand and are dropped from the map when the last wire to
+ * their address is removed or the admin stops.
+ */
+typedef struct wiring_tcp_connection {
+	wiring_admin_pt admin;
+	char* address;
+	int socket;
+
+	celix_thread_mutex_t lock; //guards writes and all fields below
+	unsigned int refCount;
+	uint32_t nextRequestId;
+	hash_map_pt pendingCalls; //key=requestId, value=wiring_tcp_pending_call
+}* wiring_tcp_connection_pt;
+
+typedef struct wiring_tcp_pending_call {
+	celix_thread_cond_t completed;
+	bool done;
+
+	celix_status_t status;
+	char* reply;
+	int replyStatus;
+
+	// only set for sendAsync, the deadline is on CLOCK_MONOTONIC
+	wiring_send_callback_pt callback;
+	void* userdata;
+	struct timespec deadline;
+}* wiring_tcp_pending_call_pt;
+
+typedef struct wiring_tcp_request {
+	wiring_tcp_connection_pt connection;
+	uint32_t requestId;
+	uint16_t type;
+	char* wireId;
+	char* data;
+	size_t length;
+}* wiring_tcp_request_pt;
+
+celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *admin);
+celix_status_t wiringAdmin_destroy(wiring_admin_pt* admin);
+celix_status_t wiringAdmin_stop(wiring_admin_pt admin);
+
+celix_status_t wiringAdmin_exportWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt* wEndpointDescription);
+celix_status_t wiringAdmin_removeExportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription);
+celix_status_t wiringAdmin_getWiringAdminProperties(wiring_admin_pt admin, properties_pt *adminProperties);
+
+celix_status_t wiringAdmin_importWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription);
+celix_status_t wiringAdmin_removeImportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription);
+
+#endif /* WIRING_ADMIN_TCP_IMPL_H_ */
@@ -0,0 +1,1357 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+
+#include <properties.h>
+
+#include "remote_service_admin.h"
+#include "remote_service_admin_inaetics.h"
+
+#include "wiring_admin.h"
+#include "wiring_admin_tcp_impl.h"
+#include "wiring_common_utils.h"
+#include "wiring_batch.h"
+
+// defines how often the server socket is rebound (with an increased port number)
+#define MAX_NUMBER_OF_RESTARTS 	5
+
+static celix_status_t wiringAdmin_send(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendSized(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus);
+static celix_status_t wiringAdmin_sendAsync(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata);
+static celix_status_t wiringAdmin_sendBatch(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses);
+static celix_status_t wiringAdmin_sendOneway(wiring_send_service_pt sendService, char *request);
+static celix_status_t wiringAdmin_call(wiring_send_service_pt sendService, uint16_t type, char *request, size_t requestLength, char **reply, int* replyStatus);
+
+static celix_status_t wiringAdmin_startServer(wiring_admin_pt admin);
+static celix_status_t wiringAdmin_stopServer(wiring_admin_pt admin);
+static void* wiringAdmin_acceptRun(void* data);
+static void* wiringAdmin_serverReaderRun(void* data);
+static void* wiringAdmin_workerRun(void* data);
+
+static celix_status_t wiringAdmin_getClientConnection(wiring_admin_pt admin, char* url, wiring_tcp_connection_pt* connection);
+static celix_status_t wiringAdmin_connect(wiring_tcp_connection_pt connection);
+static celix_status_t wiringAdmin_sendRequest(wiring_send_service_pt sendService, uint16_t type, char *request, size_t requestLength, wiring_tcp_pending_call_pt pendingCall, wiring_tcp_connection_pt* connection, uint32_t* requestId);
+static void* wiringAdmin_clientReaderRun(void* data);
+static void wiringAdmin_completePendingCall(wiring_tcp_pending_call_pt pendingCall, celix_status_t status, char* reply, int replyStatus);
+static int wiringAdmin_replyStatus(uint16_t type);
+static void wiringAdmin_expirePendingCalls(wiring_tcp_connection_pt connection);
+static void wiringAdmin_dropClientConnection(wiring_admin_pt admin, char* url);
+static void wiringAdmin_getDeadline(int timeout, struct timespec* deadline);
+static long wiringAdmin_getRemainingTime(struct timespec* deadline);
+
+static celix_status_t wiringAdmin_createConnection(wiring_admin_pt admin, int socket, char* address, wiring_tcp_connection_pt* connection);
+static void wiringAdmin_releaseConnection(wiring_tcp_connection_pt connection);
+static void wiringAdmin_destroyConnection(wiring_tcp_connection_pt connection);
+
+static celix_status_t wiringAdmin_readFully(int socket, void* buffer, size_t length);
+static celix_status_t wiringAdmin_readFrame(int socket, uint32_t* requestId, uint16_t* type, char** wireId, char** payload, size_t* length);
+static celix_status_t wiringAdmin_writeFrame(int socket, uint32_t requestId, uint16_t type, const char* wireId, const char* payload, size_t payloadLength);
+
+celix_status_t wiringAdmin_create(bundle_context_pt context, wiring_admin_pt *admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    *admin = calloc(1, sizeof(**admin));
+    if (!*admin) {
+        status = CELIX_ENOMEM;
+    } else {
+        char* timeout = NULL;
+
+        (*admin)->context = context;
+        (*admin)->serverSocket = -1;
+
+        bundleContext_getProperty(context, WIRING_ADMIN_TCP_TIMEOUT_MS, &timeout);
+        (*admin)->timeout = (timeout != NULL) ? atoi(timeout) : DEFAULT_WA_TCP_TIMEOUT_MS;
+
+        (*admin)->wiringSendServices = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
+        (*admin)->wiringSendRegistrations = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
+        (*admin)->clientConnections = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+        arrayList_create(&(*admin)->serverConnections);
+        arrayList_create(&(*admin)->requestQueue);
+
+        (*admin)->adminProperties = properties_create();
+
+        properties_set((*admin)->adminProperties, WIRING_ADMIN_PROPERTIES_SECURE_KEY, WIRING_ADMIN_PROPERTIES_SECURE_VALUE);
+        properties_set((*admin)->adminProperties, WIRING_ADMIN_PROPERTIES_CONFIG_KEY, WIRING_ADMIN_PROPERTIES_CONFIG_VALUE);
+
+        celixThreadMutex_create(&(*admin)->exportedWiringEndpointLock, NULL);
+        celixThreadMutex_create(&(*admin)->importedWiringEndpointLock, NULL);
+        celixThreadMutex_create(&(*admin)->serverConnectionsLock, NULL);
+        celixThreadCondition_init(&(*admin)->serverConnectionsClosed, NULL);
+        celixThreadMutex_create(&(*admin)->requestQueueLock, NULL);
+        celixThreadCondition_init(&(*admin)->requestQueued, NULL);
+        celixThreadMutex_create(&(*admin)->clientConnectionsLock, NULL);
+        celixThreadMutex_create(&(*admin)->clientReadersLock, NULL);
+        celixThreadCondition_init(&(*admin)->clientReadersStopped, NULL);
+
+        status = wiringReceiveRegistry_create(context, TAG, &(*admin)->receiveRegistry);
+    }
+
+    return status;
+}
+
+celix_status_t wiringAdmin_getWiringAdminProperties(wiring_admin_pt admin, properties_pt *adminProperties) {
+
+    celix_status_t status = CELIX_SUCCESS;
+
+    *adminProperties = admin->adminProperties;
+
+    return status;
+
+}
+
+celix_status_t wiringAdmin_destroy(wiring_admin_pt* admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    status = wiringAdmin_stopServer(*admin);
+
+    celixThreadMutex_destroy(&((*admin)->exportedWiringEndpointLock));
+
+    // the server and its workers are stopped, so no request reaches the receivers anymore
+    if ((*admin)->receiveRegistry != NULL) {
+        wiringReceiveRegistry_destroy(&(*admin)->receiveRegistry);
+    }
+
+    celixThreadMutex_lock(&((*admin)->importedWiringEndpointLock));
+    hashMap_destroy((*admin)->wiringSendServices, false, false);
+    hashMap_destroy((*admin)->wiringSendRegistrations, false, false);
+    celixThreadMutex_unlock(&((*admin)->importedWiringEndpointLock));
+    celixThreadMutex_destroy(&((*admin)->importedWiringEndpointLock));
+
+    hashMap_destroy((*admin)->clientConnections, false, false);
+    celixThreadCondition_destroy(&((*admin)->clientReadersStopped));
+    celixThreadMutex_destroy(&((*admin)->clientReadersLock));
+    celixThreadMutex_destroy(&((*admin)->clientConnectionsLock));
+
+    arrayList_destroy((*admin)->serverConnections);
+    celixThreadCondition_destroy(&((*admin)->serverConnectionsClosed));
+    celixThreadMutex_destroy(&((*admin)->serverConnectionsLock));
+
+    arrayList_destroy((*admin)->requestQueue);
+    celixThreadCondition_destroy(&((*admin)->requestQueued));
+    celixThreadMutex_destroy(&((*admin)->requestQueueLock));
+
+    properties_destroy((*admin)->adminProperties);
+
+    free(*admin);
+    *admin = NULL;
+
+    return status;
+}
+
+celix_status_t wiringAdmin_stop(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
+
+    wiringReceiveRegistry_untrackAll(admin->receiveRegistry);
+    wiringAdmin_stopServer(admin);
+
+    celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
+
+    // close all outgoing connections, their readers fail the calls still in flight
+    celixThreadMutex_lock(&admin->clientConnectionsLock);
+
+    hash_map_iterator_pt iter = hashMapIterator_create(admin->clientConnections);
+
+    while (hashMapIterator_hasNext(iter)) {
+        wiring_tcp_connection_pt connection = hashMapIterator_nextValue(iter);
+
+        celixThreadMutex_lock(&connection->lock);
+        if (connection->socket >= 0) {
+            shutdown(connection->socket, SHUT_RDWR);
+        }
+        celixThreadMutex_unlock(&connection->lock);
+    }
+
+    hashMapIterator_destroy(iter);
+
+    celixThreadMutex_unlock(&admin->clientConnectionsLock);
+
+    celixThreadMutex_lock(&admin->clientReadersLock);
+    while (admin->activeClientReaders > 0) {
+        celixThreadCondition_wait(&admin->clientReadersStopped, &admin->clientReadersLock);
+    }
+    celixThreadMutex_unlock(&admin->clientReadersLock);
+
+    celixThreadMutex_lock(&admin->clientConnectionsLock);
+
+    // calls still holding a connection keep it alive until they return
+    iter = hashMapIterator_create(admin->clientConnections);
+
+    while (hashMapIterator_hasNext(iter)) {
+        wiringAdmin_releaseConnection(hashMapIterator_nextValue(iter));
+    }
+
+    hashMapIterator_destroy(iter);
+    hashMap_clear(admin->clientConnections, false, false);
+
+    celixThreadMutex_unlock(&admin->clientConnectionsLock);
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_startServer(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    unsigned int port_counter = 0;
+    char *port = NULL;
+    char *ip = NULL;
+    char *detectedIp = NULL;
+    char *numThreads = NULL;
+    int currentPort = 0;
+
+    bundleContext_getProperty(admin->context, WIRING_ADMIN_TCP_PORT, &port);
+    if (port == NULL) {
+        port = (char *) DEFAULT_WA_TCP_PORT;
+    }
+
+    currentPort = atoi(port);
+
+    bundleContext_getProperty(admin->context, NODE_DISCOVERY_NODE_WA_ADDRESS, &ip);
+    if (ip == NULL) {
+        char *interface = NULL;
+
+        bundleContext_getProperty(admin->context, NODE_DISCOVERY_NODE_WA_ITF, &interface);
+        if ((interface != NULL) && (wiring_getIpAddress(interface, &detectedIp) != CELIX_SUCCESS)) {
+            printf("%s: Could not retrieve IP adress for interface %s\n", TAG, interface);
+        }
+
+        if (detectedIp == NULL) {
+            wiring_getIpAddress(NULL, &detectedIp);
+        }
+
+        ip = detectedIp;
+    }
+
+    admin->serverSocket = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (admin->serverSocket < 0) {
+        status = CELIX_FILE_IO_EXCEPTION;
+    } else {
+        struct sockaddr_in addr;
+        int reuse = 1;
+        int bound = -1;
+
+        setsockopt(admin->serverSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+        do {
+            addr.sin_port = htons(currentPort);
+
+            bound = bind(admin->serverSocket, (struct sockaddr*) &addr, sizeof(addr));
+
+            if (bound != 0) {
+                printf("%s: Error while binding to port %d - retrying on port %d...\n", TAG, currentPort, currentPort + 1);
+                currentPort++;
+                port_counter++;
+            }
+        } while (bound != 0 && port_counter < MAX_NUMBER_OF_RESTARTS);
+
+        if (bound != 0 || listen(admin->serverSocket, SOMAXCONN) != 0) {
+            close(admin->serverSocket);
+            admin->serverSocket = -1;
+            status = CELIX_FILE_IO_EXCEPTION;
+        }
+    }
+
+    if (status == CELIX_SUCCESS) {
+        int i;
+
+        snprintf(admin->url, MAX_URL_LENGTH, "tcp://%s:%d", (ip != NULL) ? ip : (char*) DEFAULT_WA_ADDRESS, currentPort);
+
+        bundleContext_getProperty(admin->context, WIRING_ADMIN_TCP_NUM_THREADS, &numThreads);
+        if (numThreads != NULL) {
+            admin->numWorkers = atoi(numThreads);
+        } else {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            admin->numWorkers = ((cpus > 0) ? cpus : 1) * DEFAULT_WA_TCP_THREADS_PER_CPU;
+        }
+
+        if (admin->numWorkers < 1) {
+            admin->numWorkers = 1;
+        }
+
+        admin->workers = calloc(admin->numWorkers, sizeof(celix_thread_t));
+        admin->workersRunning = true;
+
+        for (i = 0; i < admin->numWorkers; i++) {
+            celixThread_create(&admin->workers[i], NULL, wiringAdmin_workerRun, admin);
+        }
+
+        admin->serverRunning = true;
+        status = celixThread_create(&admin->acceptThread, NULL, wiringAdmin_acceptRun, admin);
+
+        printf("%s: TCP Wiring Endpoint running at %s with %d worker threads\n", TAG, admin->url, admin->numWorkers);
+    } else {
+        printf("%s: Could not start TCP Wiring Endpoint\n", TAG);
+    }
+
+    if (detectedIp != NULL) {
+        free(detectedIp);
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_stopServer(wiring_admin_pt admin) {
+    celix_status_t status = CELIX_SUCCESS;
+    int i;
+
+    if (admin->serverSocket >= 0) {
+        printf("%s: Stopping TCP Wiring Endpoint running at %s ...\n", TAG, admin->url);
+
+        admin->serverRunning = false;
+        shutdown(admin->serverSocket, SHUT_RDWR);
+        celixThread_join(admin->acceptThread, NULL);
+
+        close(admin->serverSocket);
+        admin->serverSocket = -1;
+
+        // wake up all readers and wait until they are gone
+        celixThreadMutex_lock(&admin->serverConnectionsLock);
+
+        for (i = 0; i < arrayList_size(admin->serverConnections); i++) {
+            wiring_tcp_connection_pt connection = arrayList_get(admin->serverConnections, i);
+            shutdown(connection->socket, SHUT_RDWR);
+        }
+
+        while (arrayList_size(admin->serverConnections) > 0) {
+            celixThreadCondition_wait(&admin->serverConnectionsClosed, &admin->serverConnectionsLock);
+        }
+
+        celixThreadMutex_unlock(&admin->serverConnectionsLock);
+
+        celixThreadMutex_lock(&admin->requestQueueLock);
+        admin->workersRunning = false;
+        celixThreadCondition_broadcast(&admin->requestQueued);
+        celixThreadMutex_unlock(&admin->requestQueueLock);
+
+        for (i = 0; i < admin->numWorkers; i++) {
+            celixThread_join(admin->workers[i], NULL);
+        }
+
+        free(admin->workers);
+        admin->workers = NULL;
+        admin->numWorkers = 0;
+
+        for (i = 0; i < arrayList_size(admin->requestQueue); i++) {
+            wiring_tcp_request_pt request = arrayList_get(admin->requestQueue, i);
+
+            wiringAdmin_releaseConnection(request->connection);
+            free(request->wireId);
+            free(request->data);
+            free(request);
+        }
+        arrayList_clear(admin->requestQueue);
+    }
+
+    return status;
+}
+
+static void* wiringAdmin_acceptRun(void* data) {
+    wiring_admin_pt admin = data;
+
+    while (admin->serverRunning) {
+        int clientSocket = accept(admin->serverSocket, NULL, NULL);
+
+        if (clientSocket < 0) {
+            if (errno != EINTR && errno != ECONNABORTED) {
+                break;
+            }
+        } else {
+            wiring_tcp_connection_pt connection = NULL;
+            celix_thread_t reader;
+            int nodelay = 1;
+
+            setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+            if (wiringAdmin_createConnection(admin, clientSocket, NULL, &connection) != CELIX_SUCCESS) {
+                close(clientSocket);
+            } else {
+                celixThreadMutex_lock(&admin->serverConnectionsLock);
+                arrayList_add(admin->serverConnections, connection);
+                celixThreadMutex_unlock(&admin->serverConnectionsLock);
+
+                if (celixThread_create(&reader, NULL, wiringAdmin_serverReaderRun, connection) == CELIX_SUCCESS) {
+                    celixThread_detach(reader);
+                } else {
+                    celixThreadMutex_lock(&admin->serverConnectionsLock);
+                    arrayList_removeElement(admin->serverConnections, connection);
+                    celixThreadMutex_unlock(&admin->serverConnectionsLock);
+
+                    wiringAdmin_releaseConnection(connection);
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void* wiringAdmin_serverReaderRun(void* data) {
+    wiring_tcp_connection_pt connection = data;
+    wiring_admin_pt admin = connection->admin;
+
+    bool running = true;
+
+    while (running) {
+        uint32_t requestId = 0;
+        uint16_t type = 0;
+        char* wireId = NULL;
+        char* payload = NULL;
+        size_t payloadLength = 0;
+
+        if (wiringAdmin_readFrame(connection->socket, &requestId, &type, &wireId, &payload, &payloadLength) != CELIX_SUCCESS) {
+            running = false;
+        } else if (type != WIRING_TCP_FRAME_REQUEST && type != WIRING_TCP_FRAME_BATCH && type != WIRING_TCP_FRAME_ONEWAY) {
+            printf("%s: Unexpected frame type %u on server connection\n", TAG, type);
+            free(wireId);
+            free(payload);
+        } else {
+            wiring_tcp_request_pt request = calloc(1, sizeof(*request));
+
+            if (!request) {
+                free(wireId);
+                free(payload);
+
+                if (type != WIRING_TCP_FRAME_ONEWAY) {
+                    celixThreadMutex_lock(&connection->lock);
+                    wiringAdmin_writeFrame(connection->socket, requestId, WIRING_TCP_FRAME_NO_REPLY, NULL, NULL, 0);
+                    celixThreadMutex_unlock(&connection->lock);
+                }
+            } else {
+                request->requestId = requestId;
+                request->type = type;
+                request->wireId = wireId;
+                request->data = payload;
+                request->length = payloadLength;
+                request->connection = connection;
+
+                celixThreadMutex_lock(&connection->lock);
+                connection->refCount++;
+                celixThreadMutex_unlock(&connection->lock);
+
+                // requests are handed to the worker pool, so one connection can have many in flight
+                celixThreadMutex_lock(&admin->requestQueueLock);
+                arrayList_add(admin->requestQueue, request);
+                celixThreadCondition_signal(&admin->requestQueued);
+                celixThreadMutex_unlock(&admin->requestQueueLock);
+            }
+        }
+    }
+
+    celixThreadMutex_lock(&admin->serverConnectionsLock);
+    arrayList_removeElement(admin->serverConnections, connection);
+    celixThreadCondition_broadcast(&admin->serverConnectionsClosed);
+    celixThreadMutex_unlock(&admin->serverConnectionsLock);
+
+    wiringAdmin_releaseConnection(connection);
+
+    return NULL;
+}
+
+static void* wiringAdmin_workerRun(void* data) {
+    wiring_admin_pt admin = data;
+
+    while (true) {
+        wiring_tcp_request_pt request = NULL;
+
+        celixThreadMutex_lock(&admin->requestQueueLock);
+
+        while (admin->workersRunning && arrayList_size(admin->requestQueue) == 0) {
+            celixThreadCondition_wait(&admin->requestQueued, &admin->requestQueueLock);
+        }
+
+        if (admin->workersRunning) {
+            request = arrayList_remove(admin->requestQueue, 0);
+        }
+
+        celixThreadMutex_unlock(&admin->requestQueueLock);
+
+        if (request == NULL) {
+            break;
+        } else {
+            char* response = NULL;
+            uint16_t type = WIRING_TCP_FRAME_NO_REPLY;
+            celix_status_t receiveStatus = CELIX_SUCCESS;
+
+            if (request->type == WIRING_TCP_FRAME_BATCH) {
+                receiveStatus = wiringReceiveRegistry_receiveBatch(admin->receiveRegistry, request->wireId, request->data, request->length, &response);
+            } else {
+                receiveStatus = wiringReceiveRegistry_receive(admin->receiveRegistry, request->wireId, request->data, &response);
+            }
+
+            if (receiveStatus == CELIX_ILLEGAL_ARGUMENT) {
+                type = WIRING_TCP_FRAME_UNKNOWN_WIRE;
+            } else if (receiveStatus == CELIX_INVALID_SYNTAX) {
+                printf("%s: Discarding malformed batch for wireId %s\n", TAG, request->wireId);
+                type = WIRING_TCP_FRAME_MALFORMED;
+            } else if (receiveStatus != CELIX_SUCCESS) {
+                printf("%s: Could not handle request for wireId %s (status %d)\n", TAG, request->wireId, receiveStatus);
+            } else if (response != NULL) {
+                type = WIRING_TCP_FRAME_REPLY;
+            }
+
+            if (request->type != WIRING_TCP_FRAME_ONEWAY) {
+                celixThreadMutex_lock(&request->connection->lock);
+                wiringAdmin_writeFrame(request->connection->socket, request->requestId, type, NULL, response, (response != NULL) ? strlen(response) : 0);
+                celixThreadMutex_unlock(&request->connection->lock);
+            }
+
+            wiringAdmin_releaseConnection(request->connection);
+
+            free(response);
+            free(request->wireId);
+            free(request->data);
+            free(request);
+        }
+    }
+
+    return NULL;
+}
+
+celix_status_t wiringAdmin_exportWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt* wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
+
+    if (admin->serverSocket < 0) {
+        status = wiringAdmin_startServer(admin);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringReceiveRegistry_createEndpoint(admin->receiveRegistry, WIRING_ADMIN_PROPERTIES_CONFIG_VALUE, wEndpointDescription);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        properties_set((*wEndpointDescription)->properties, WIRING_ENDPOINT_DESCRIPTION_TCP_URL_KEY, admin->url);
+
+        status = wiringReceiveRegistry_track(admin->receiveRegistry, *wEndpointDescription);
+
+        if (status != CELIX_SUCCESS) {
+            wiringEndpointDescription_destroy(wEndpointDescription);
+        }
+    } else {
+        printf("%s: Cannot export Wiring Endpoint\n", TAG);
+    }
+
+    if (wiringReceiveRegistry_getTrackedCount(admin->receiveRegistry) == 0) {
+        wiringAdmin_stopServer(admin);
+    }
+
+    celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
+
+    return status;
+}
+
+celix_status_t wiringAdmin_removeExportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    if (wEndpointDescription == NULL) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else {
+        celixThreadMutex_lock(&admin->exportedWiringEndpointLock);
+
+        if (wiringReceiveRegistry_untrack(admin->receiveRegistry, wEndpointDescription) == CELIX_SUCCESS
+                && wiringReceiveRegistry_getTrackedCount(admin->receiveRegistry) == 0) {
+            wiringAdmin_stopServer(admin);
+        }
+
+        wiringEndpointDescription_destroy(&wEndpointDescription);
+
+        celixThreadMutex_unlock(&admin->exportedWiringEndpointLock);
+    }
+
+    return status;
+}
+
+celix_status_t wiringAdmin_importWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_send_service_pt wiringSendService = calloc(1, sizeof(*wiringSendService));
+
+    if (!wiringSendService) {
+        status = CELIX_ENOMEM;
+    } else if (properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_TCP_URL_KEY) == NULL) {
+        free(wiringSendService);
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else {
+        service_registration_pt wiringSendServiceReg = NULL;
+
+        wiringSendService->wiringEndpointDescription = wEndpointDescription;
+        wiringSendService->send = wiringAdmin_send;
+        wiringSendService->sendSized = wiringAdmin_sendSized;
+        wiringSendService->sendAsync = wiringAdmin_sendAsync;
+        wiringSendService->sendBatch = wiringAdmin_sendBatch;
+        wiringSendService->sendOneway = wiringAdmin_sendOneway;
+        // no streaming, frames are bounded by WIRING_TCP_MAX_PAYLOAD_LENGTH
+        wiringSendService->sendStream = NULL;
+        wiringSendService->admin = admin;
+
+        celixThreadMutex_lock(&admin->importedWiringEndpointLock);
+
+        status = wiring_registerSendService(admin->context, TAG, wiringSendService, &wiringSendServiceReg);
+
+        if (status == CELIX_SUCCESS) {
+            hashMap_put(admin->wiringSendServices, wEndpointDescription, wiringSendService);
+            hashMap_put(admin->wiringSendRegistrations, wEndpointDescription, wiringSendServiceReg);
+        } else {
+            free(wiringSendService);
+        }
+
+        celixThreadMutex_unlock(&admin->importedWiringEndpointLock);
+    }
+
+    return status;
+}
+
+celix_status_t wiringAdmin_removeImportedWiringEndpoint(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpointDescription) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    celixThreadMutex_lock(&admin->importedWiringEndpointLock);
+    char* wireId = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+
+    printf("%s: remove Wiring Endpoint w/ wireId %s\n", TAG, wireId);
+
+    wiring_send_service_pt wiringSendService = hashMap_remove(admin->wiringSendServices, wEndpointDescription);
+    service_registration_pt wiringSendRegistration = hashMap_remove(admin->wiringSendRegistrations, wEndpointDescription);
+
+    status = serviceRegistration_unregister(wiringSendRegistration);
+
+    if (status == CELIX_SUCCESS) {
+        free(wiringSendService);
+    }
+
+    char* url = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_TCP_URL_KEY);
+    bool urlInUse = false;
+
+    hash_map_iterator_pt iter = hashMapIterator_create(admin->wiringSendServices);
+
+    while (!urlInUse && hashMapIterator_hasNext(iter)) {
+        wiring_send_service_pt other = hashMapIterator_nextValue(iter);
+        char* otherUrl = properties_get(other->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_TCP_URL_KEY);
+
+        urlInUse = (url != NULL && otherUrl != NULL && strcmp(url, otherUrl) == 0);
+    }
+
+    hashMapIterator_destroy(iter);
+
+    // the connection is shared by all wires of the exporting framework
+    if (url != NULL && !urlInUse) {
+        wiringAdmin_dropClientConnection(admin, url);
+    }
+
+    celixThreadMutex_unlock(&admin->importedWiringEndpointLock);
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_send(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus) {
+    return wiringAdmin_call(sendService, WIRING_TCP_FRAME_REQUEST, request, strlen(request), reply, replyStatus);
+}
+
+static celix_status_t wiringAdmin_sendSized(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus) {
+    return wiringAdmin_call(sendService, WIRING_TCP_FRAME_REQUEST, request, requestLength, reply, replyStatus);
+}
+
+static celix_status_t wiringAdmin_sendBatch(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    char* data = NULL;
+    size_t length = 0;
+    char* reply = NULL;
+    int replyStatus = 0;
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        replies[i] = NULL;
+        replyStatuses[i] = 0;
+    }
+
+    status = wiringBatch_encode(count, requests, NULL, &data, &length);
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringAdmin_call(sendService, WIRING_TCP_FRAME_BATCH, data, length, &reply, &replyStatus);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        if (reply == NULL) {
+            // unknown wire or a batch the receiver could not handle
+            for (i = 0; i < count; i++) {
+                replyStatuses[i] = replyStatus;
+            }
+        } else {
+            status = wiringBatch_decodeReplies(reply, strlen(reply), count, replies, replyStatuses);
+        }
+    }
+
+    free(reply);
+    free(data);
+
+    return status;
+}
+
+// returns once the frame is written, the receiving admin does not answer it
+static celix_status_t wiringAdmin_sendOneway(wiring_send_service_pt sendService, char *request) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_tcp_connection_pt connection = NULL;
+    uint32_t requestId = 0;
+
+    status = wiringAdmin_sendRequest(sendService, WIRING_TCP_FRAME_ONEWAY, request, strlen(request), NULL, &connection, &requestId);
+
+    if (status == CELIX_SUCCESS) {
+        wiringAdmin_releaseConnection(connection);
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_call(wiring_send_service_pt sendService, uint16_t type, char *request, size_t requestLength, char **reply, int* replyStatus) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    struct wiring_tcp_pending_call pendingCall;
+    wiring_tcp_connection_pt connection = NULL;
+    uint32_t requestId = 0;
+
+    memset(&pendingCall, 0, sizeof(pendingCall));
+    celixThreadCondition_init(&pendingCall.completed, NULL);
+
+    status = wiringAdmin_sendRequest(sendService, type, request, requestLength, &pendingCall, &connection, &requestId);
+
+    if (status == CELIX_SUCCESS) {
+        struct timespec deadline;
+        long remaining = 0;
+
+        wiringAdmin_getDeadline(sendService->admin->timeout, &deadline);
+
+        celixThreadMutex_lock(&connection->lock);
+
+        while (!pendingCall.done && (remaining = wiringAdmin_getRemainingTime(&deadline)) > 0) {
+            celixThreadCondition_timedwaitRelative(&pendingCall.completed, &connection->lock, remaining / 1000, (remaining % 1000) * 1000000L);
+        }
+
+        if (!pendingCall.done) {
+            // a reply arriving later finds no pending call anymore and is dropped
+            hashMap_remove(connection->pendingCalls, (void*) (uintptr_t) requestId);
+            pendingCall.status = CELIX_ILLEGAL_STATE;
+            pendingCall.replyStatus = ETIMEDOUT;
+        }
+
+        celixThreadMutex_unlock(&connection->lock);
+
+        wiringAdmin_releaseConnection(connection);
+
+        status = pendingCall.status;
+        *replyStatus = pendingCall.replyStatus;
+
+        if (pendingCall.reply != NULL) {
+            *reply = pendingCall.reply;
+        }
+    }
+
+    celixThreadCondition_destroy(&pendingCall.completed);
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_sendAsync(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_tcp_pending_call_pt pendingCall = calloc(1, sizeof(*pendingCall));
+    wiring_tcp_connection_pt connection = NULL;
+    uint32_t requestId = 0;
+
+    if (!pendingCall) {
+        status = CELIX_ENOMEM;
+    } else {
+        pendingCall->callback = callback;
+        pendingCall->userdata = userdata;
+        wiringAdmin_getDeadline(sendService->admin->timeout, &pendingCall->deadline);
+
+        // the request is written to the socket before returning, so it does not need to be copied
+        status = wiringAdmin_sendRequest(sendService, WIRING_TCP_FRAME_REQUEST, request, strlen(request), pendingCall, &connection, &requestId);
+
+        if (status == CELIX_SUCCESS) {
+            wiringAdmin_releaseConnection(connection);
+        } else {
+            free(pendingCall);
+        }
+    }
+
+    return status;
+}
+
+/*
+ * Registers the pending call and writes the request frame. Once CELIX_SUCCESS is returned the
+ * connection's reader completes the call, either with the reply or when the connection breaks,
+ * and the caller holds a reference to the connection it has to release. One-way frames have no
+ * pending call.
+ */
+static celix_status_t wiringAdmin_sendRequest(wiring_send_service_pt sendService, uint16_t type, char *request, size_t requestLength, wiring_tcp_pending_call_pt pendingCall, wiring_tcp_connection_pt* connection, uint32_t* requestId) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    char* url = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_TCP_URL_KEY);
+    char* wireId = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+
+    status = wiringAdmin_getClientConnection(sendService->admin, url, connection);
+
+    if (status == CELIX_SUCCESS) {
+        celixThreadMutex_lock(&(*connection)->lock);
+
+        if ((*connection)->socket < 0) {
+            status = wiringAdmin_connect(*connection);
+        }
+
+        if (status == CELIX_SUCCESS) {
+            // zero is never used as request id
+            do {
+                *requestId = ++(*connection)->nextRequestId;
+            } while (*requestId == 0);
+
+            if (pendingCall != NULL) {
+                hashMap_put((*connection)->pendingCalls, (void*) (uintptr_t) *requestId, pendingCall);
+            }
+
+            status = wiringAdmin_writeFrame((*connection)->socket, *requestId, type, wireId, request, requestLength);
+
+            if (status != CELIX_SUCCESS) {
+                // the reader notices the broken connection and fails the other calls in flight
+                hashMap_remove((*connection)->pendingCalls, (void*) (uintptr_t) *requestId);
+                shutdown((*connection)->socket, SHUT_RDWR);
+            }
+        }
+
+        celixThreadMutex_unlock(&(*connection)->lock);
+
+        if (status != CELIX_SUCCESS) {
+            wiringAdmin_releaseConnection(*connection);
+            *connection = NULL;
+        }
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_getClientConnection(wiring_admin_pt admin, char* url, wiring_tcp_connection_pt* connection) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    celixThreadMutex_lock(&admin->clientConnectionsLock);
+
+    *connection = hashMap_get(admin->clientConnections, url);
+
+    if (*connection == NULL) {
+        status = wiringAdmin_createConnection(admin, -1, url, connection);
+
+        if (status == CELIX_SUCCESS) {
+            hashMap_put(admin->clientConnections, (*connection)->address, *connection);
+        }
+    }
+
+    // one reference is owned by the map, the other one by the caller
+    if (status == CELIX_SUCCESS) {
+        celixThreadMutex_lock(&(*connection)->lock);
+        (*connection)->refCount++;
+        celixThreadMutex_unlock(&(*connection)->lock);
+    }
+
+    celixThreadMutex_unlock(&admin->clientConnectionsLock);
+
+    return status;
+}
+
+// the reader fails the calls still in flight, callers holding the connection keep it alive until they return
+static void wiringAdmin_dropClientConnection(wiring_admin_pt admin, char* url) {
+    wiring_tcp_connection_pt connection = NULL;
+
+    celixThreadMutex_lock(&admin->clientConnectionsLock);
+    connection = hashMap_remove(admin->clientConnections, url);
+    celixThreadMutex_unlock(&admin->clientConnectionsLock);
+
+    if (connection != NULL) {
+        celixThreadMutex_lock(&connection->lock);
+        if (connection->socket >= 0) {
+            shutdown(connection->socket, SHUT_RDWR);
+        }
+        celixThreadMutex_unlock(&connection->lock);
+
+        wiringAdmin_releaseConnection(connection);
+    }
+}
+
+// caller holds connection->lock
+static celix_status_t wiringAdmin_connect(wiring_tcp_connection_pt connection) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    wiring_admin_pt admin = connection->admin;
+    char host[MAX_URL_LENGTH];
+    char* port = NULL;
+    struct addrinfo hints;
+    struct addrinfo* result = NULL;
+
+    if (sscanf(connection->address, "tcp://%127[^:]", host) != 1 || (port = strrchr(connection->address, ':')) == NULL) {
+        status = CELIX_ILLEGAL_ARGUMENT;
+    } else {
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+
+        if (getaddrinfo(host, port + 1, &hints, &result) != 0) {
+            status = CELIX_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    if (status == CELIX_SUCCESS) {
+        int sock = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+
+        if (sock < 0) {
+            status = CELIX_FILE_IO_EXCEPTION;
+        } else {
+            struct timeval timeout;
+            int nodelay = 1;
+            int keepalive = 1;
+
+            // on Linux the send timeout also bounds connect()
+            timeout.tv_sec = admin->timeout / 1000;
+            timeout.tv_usec = (admin->timeout % 1000) * 1000;
+            setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+
+            if (connect(sock, result->ai_addr, result->ai_addrlen) != 0) {
+                printf("%s: Could not connect to %s\n", TAG, connection->address);
+                close(sock);
+                status = CELIX_FILE_IO_EXCEPTION;
+            } else {
+                celix_thread_t reader;
+
+                connection->socket = sock;
+                // released by the reader once it is done with the connection
+                connection->refCount++;
+
+                celixThreadMutex_lock(&admin->clientReadersLock);
+                admin->activeClientReaders++;
+                celixThreadMutex_unlock(&admin->clientReadersLock);
+
+                if (celixThread_create(&reader, NULL, wiringAdmin_clientReaderRun, connection) == CELIX_SUCCESS) {
+                    celixThread_detach(reader);
+                } else {
+                    celixThreadMutex_lock(&admin->clientReadersLock);
+                    admin->activeClientReaders--;
+                    celixThreadMutex_unlock(&admin->clientReadersLock);
+
+                    connection->refCount--;
+                    close(sock);
+                    connection->socket = -1;
+                    status = CELIX_ILLEGAL_STATE;
+                }
+            }
+        }
+
+        freeaddrinfo(result);
+    }
+
+    return status;
+}
+
+static void* wiringAdmin_clientReaderRun(void* data) {
+    wiring_tcp_connection_pt connection = data;
+    wiring_admin_pt admin = connection->admin;
+
+    // only this thread closes the socket, so the descriptor stays valid while it is read
+    int sock = connection->socket;
+    bool running = true;
+    struct timespec nextSweep;
+
+    wiringAdmin_getDeadline(WIRING_TCP_SWEEP_INTERVAL_MS, &nextSweep);
+
+    while (running) {
+        uint32_t requestId = 0;
+        uint16_t type = 0;
+        char* wireId = NULL;
+        char* payload = NULL;
+        struct pollfd pollSocket;
+        int ready = 0;
+
+        pollSocket.fd = sock;
+        pollSocket.events = POLLIN;
+        pollSocket.revents = 0;
+
+        // asynchronous calls have nobody waiting for them, so their deadline is checked in between frames
+        if (wiringAdmin_getRemainingTime(&nextSweep) <= 0) {
+            wiringAdmin_expirePendingCalls(connection);
+            wiringAdmin_getDeadline(WIRING_TCP_SWEEP_INTERVAL_MS, &nextSweep);
+        }
+
+        ready = poll(&pollSocket, 1, WIRING_TCP_SWEEP_INTERVAL_MS);
+
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            // nothing to read
+        } else if (ready < 0 || wiringAdmin_readFrame(sock, &requestId, &type, &wireId, &payload, NULL) != CELIX_SUCCESS) {
+            running = false;
+        } else {
+            wiring_tcp_pending_call_pt pendingCall = NULL;
+
+            celixThreadMutex_lock(&connection->lock);
+
+            pendingCall = hashMap_remove(connection->pendingCalls, (void*) (uintptr_t) requestId);
+
+            if (pendingCall != NULL && pendingCall->callback == NULL) {
+                switch (type) {
+                    case WIRING_TCP_FRAME_REPLY:
+                        wiringAdmin_completePendingCall(pendingCall, CELIX_SUCCESS, payload, 0);
+                        payload = NULL;
+                        break;
+                    default:
+                        wiringAdmin_completePendingCall(pendingCall, CELIX_SUCCESS, NULL, wiringAdmin_replyStatus(type));
+                        break;
+                }
+                pendingCall = NULL;
+            }
+
+            celixThreadMutex_unlock(&connection->lock);
+
+            // asynchronous callbacks run without the connection lock, they may send again
+            if (pendingCall != NULL) {
+                if (type == WIRING_TCP_FRAME_REPLY) {
+                    pendingCall->callback(pendingCall->userdata, CELIX_SUCCESS, payload, 0);
+                    payload = NULL;
+                } else {
+                    pendingCall->callback(pendingCall->userdata, CELIX_SUCCESS, NULL, wiringAdmin_replyStatus(type));
+                }
+                free(pendingCall);
+            }
+
+            free(wireId);
+            free(payload);
+        }
+    }
+
+    celixThreadMutex_lock(&connection->lock);
+
+    hash_map_pt pendingCalls = connection->pendingCalls;
+    connection->pendingCalls = hashMap_create(NULL, NULL, NULL, NULL);
+
+    close(sock);
+    connection->socket = -1;
+
+    hash_map_iterator_pt iter = hashMapIterator_create(pendingCalls);
+    while (hashMapIterator_hasNext(iter)) {
+        wiring_tcp_pending_call_pt pendingCall = hashMapIterator_nextValue(iter);
+
+        if (pendingCall->callback == NULL) {
+            wiringAdmin_completePendingCall(pendingCall, CELIX_ILLEGAL_STATE, NULL, 0);
+            hashMapIterator_remove(iter);
+        }
+    }
+    hashMapIterator_destroy(iter);
+
+    celixThreadMutex_unlock(&connection->lock);
+
+    iter = hashMapIterator_create(pendingCalls);
+    while (hashMapIterator_hasNext(iter)) {
+        wiring_tcp_pending_call_pt pendingCall = hashMapIterator_nextValue(iter);
+
+        pendingCall->callback(pendingCall->userdata, CELIX_ILLEGAL_STATE, NULL, 0);
+        free(pendingCall);
+    }
+    hashMapIterator_destroy(iter);
+    hashMap_destroy(pendingCalls, false, false);
+
+    wiringAdmin_releaseConnection(connection);
+
+    celixThreadMutex_lock(&admin->clientReadersLock);
+    admin->activeClientReaders--;
+    celixThreadCondition_broadcast(&admin->clientReadersStopped);
+    celixThreadMutex_unlock(&admin->clientReadersLock);
+
+    return NULL;
+}
+
+// caller holds the lock of the connection the call belongs to
+static void wiringAdmin_completePendingCall(wiring_tcp_pending_call_pt pendingCall, celix_status_t status, char* reply, int replyStatus) {
+    pendingCall->status = status;
+    pendingCall->reply = reply;
+    pendingCall->replyStatus = replyStatus;
+    pendingCall->done = true;
+
+    celixThreadCondition_broadcast(&pendingCall->completed);
+}
+
+// the HTTP status the wiring admin would have answered a frame without payload with
+static int wiringAdmin_replyStatus(uint16_t type) {
+    int replyStatus = 204;
+
+    if (type == WIRING_TCP_FRAME_UNKNOWN_WIRE) {
+        replyStatus = 404;
+    } else if (type == WIRING_TCP_FRAME_MALFORMED) {
+        replyStatus = 400;
+    }
+
+    return replyStatus;
+}
+
+// fails the asynchronous calls of the connection that are past their deadline, as a timed out send would
+static void wiringAdmin_expirePendingCalls(wiring_tcp_connection_pt connection) {
+    array_list_pt expired = NULL;
+    int i;
+
+    arrayList_create(&expired);
+
+    celixThreadMutex_lock(&connection->lock);
+
+    hash_map_iterator_pt iter = hashMapIterator_create(connection->pendingCalls);
+    while (hashMapIterator_hasNext(iter)) {
+        wiring_tcp_pending_call_pt pendingCall = hashMapIterator_nextValue(iter);
+
+        if (pendingCall->callback != NULL && wiringAdmin_getRemainingTime(&pendingCall->deadline) <= 0) {
+            // a reply arriving later finds no pending call anymore and is dropped
+            hashMapIterator_remove(iter);
+            arrayList_add(expired, pendingCall);
+        }
+    }
+    hashMapIterator_destroy(iter);
+
+    celixThreadMutex_unlock(&connection->lock);
+
+    for (i = 0; i < arrayList_size(expired); i++) {
+        wiring_tcp_pending_call_pt pendingCall = arrayList_get(expired, i);
+
+        pendingCall->callback(pendingCall->userdata, CELIX_ILLEGAL_STATE, NULL, ETIMEDOUT);
+        free(pendingCall);
+    }
+
+    arrayList_destroy(expired);
+}
+
+static void wiringAdmin_getDeadline(int timeout, struct timespec* deadline) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+
+    deadline->tv_sec += timeout / 1000;
+    deadline->tv_nsec += (timeout % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+// in ms rounded up, zero or less once the deadline has passed
+static long wiringAdmin_getRemainingTime(struct timespec* deadline) {
+    struct timespec now;
+    long long remaining = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    remaining = (deadline->tv_sec - now.tv_sec) * 1000000000LL + (deadline->tv_nsec - now.tv_nsec);
+
+    return (remaining > 0) ? (long) ((remaining + 999999) / 1000000) : 0;
+}
+
+static celix_status_t wiringAdmin_createConnection(wiring_admin_pt admin, int socket, char* address, wiring_tcp_connection_pt* connection) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    *connection = calloc(1, sizeof(**connection));
+
+    if (!*connection) {
+        status = CELIX_ENOMEM;
+    } else {
+        (*connection)->admin = admin;
+        (*connection)->socket = socket;
+        (*connection)->refCount = 1;
+        (*connection)->address = (address != NULL) ? strdup(address) : NULL;
+        (*connection)->pendingCalls = hashMap_create(NULL, NULL, NULL, NULL);
+
+        celixThreadMutex_create(&(*connection)->lock, NULL);
+    }
+
+    return status;
+}
+
+static void wiringAdmin_releaseConnection(wiring_tcp_connection_pt connection) {
+    bool last = false;
+
+    celixThreadMutex_lock(&connection->lock);
+    last = (--connection->refCount == 0);
+    celixThreadMutex_unlock(&connection->lock);
+
+    if (last) {
+        if (connection->socket >= 0) {
+            close(connection->socket);
+        }
+        wiringAdmin_destroyConnection(connection);
+    }
+}
+
+static void wiringAdmin_destroyConnection(wiring_tcp_connection_pt connection) {
+    hashMap_destroy(connection->pendingCalls, false, false);
+    celixThreadMutex_destroy(&connection->lock);
+    free(connection->address);
+    free(connection);
+}
+
+static celix_status_t wiringAdmin_readFully(int socket, void* buffer, size_t length) {
+    celix_status_t status = CELIX_SUCCESS;
+    size_t received = 0;
+
+    while (status == CELIX_SUCCESS && received < length) {
+        ssize_t bytes = recv(socket, (char*) buffer + received, length - received, 0);
+
+        if (bytes > 0) {
+            received += bytes;
+        } else if (bytes < 0 && errno == EINTR) {
+            continue;
+        } else {
+            status = CELIX_FILE_IO_EXCEPTION;
+        }
+    }
+
+    return status;
+}
+
+static celix_status_t wiringAdmin_readFrame(int socket, uint32_t* requestId, uint16_t* type, char** wireId, char** payload, size_t* length) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    unsigned char header[WIRING_TCP_HEADER_SIZE];
+    uint16_t wireIdLength = 0;
+    uint32_t payloadLength = 0;
+
+    *wireId = NULL;
+    *payload = NULL;
+
+    status = wiringAdmin_readFully(socket, header, sizeof(header));
+
+    if (status == CELIX_SUCCESS) {
+        uint32_t value32;
+        uint16_t value16;
+
+        memcpy(&value32, &header[0], sizeof(value32));
+        *requestId = ntohl(value32);
+        memcpy(&value16, &header[4], sizeof(value16));
+        *type = ntohs(value16);
+        memcpy(&value16, &header[6], sizeof(value16));
+        wireIdLength = ntohs(value16);
+        memcpy(&value32, &header[8], sizeof(value32));
+        payloadLength = ntohl(value32);
+
+        if (payloadLength > WIRING_TCP_MAX_PAYLOAD_LENGTH) {
+            printf("%s: Frame of %u bytes exceeds the maximum payload length\n", TAG, payloadLength);
+            status = CELIX_ILLEGAL_ARGUMENT;
+        }
+    }
+
+    if (status == CELIX_SUCCESS) {
+        *wireId = malloc(wireIdLength + 1);
+        *payload = malloc(payloadLength + 1);
+
+        if (*wireId == NULL || *payload == NULL) {
+            status = CELIX_ENOMEM;
+        }
+    }
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringAdmin_readFully(socket, *wireId, wireIdLength);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        status = wiringAdmin_readFully(socket, *payload, payloadLength);
+    }
+
+    if (status == CELIX_SUCCESS) {
+        (*wireId)[wireIdLength] = '\0';
+        (*payload)[payloadLength] = '\0';
+
+        if (length != NULL) {
+            *length = payloadLength;
+        }
+    } else {
+        free(*wireId);
+        free(*payload);
+        *wireId = NULL;
+        *payload = NULL;
+    }
+
+    return status;
+}
+
+// caller holds the connection lock, so frames of different threads do not interleave
+static celix_status_t wiringAdmin_writeFrame(int socket, uint32_t requestId, uint16_t type, const char* wireId, const char* payload, size_t payloadLength) {
+    celix_status_t status = CELIX_SUCCESS;
+
+    unsigned char header[WIRING_TCP_HEADER_SIZE];
+    size_t wireIdLength = (wireId != NULL) ? strlen(wireId) : 0;
+    uint32_t value32;
+    uint16_t value16;
+
+    if (socket < 0 || wireIdLength > UINT16_MAX || payloadLength > WIRING_TCP_MAX_PAYLOAD_LENGTH) {
+        return CELIX_ILLEGAL_ARGUMENT;
+    }
+
+    value32 = htonl(requestId);
+    memcpy(&header[0], &value32, sizeof(value32));
+    value16 = htons(type);
+    memcpy(&header[4], &value16, sizeof(value16));
+    value16 = htons((uint16_t) wireIdLength);
+    memcpy(&header[6], &value16, sizeof(value16));
+    value32 = htonl((uint32_t) payloadLength);
+    memcpy(&header[8], &value32, sizeof(value32));
+
+    // header, wire id and payload leave in a single system call
+    struct iovec iov[3];
+    struct msghdr msg;
+    int iovIndex = 0;
+
+    iov[0].iov_base = header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = (void*) wireId;
+    iov[1].iov_len = wireIdLength;
+    iov[2].iov_base = (void*) payload;
+    iov[2].iov_len = payloadLength;
+
+    while (status == CELIX_SUCCESS && iovIndex < 3) {
+        ssize_t bytes;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov[iovIndex];
+        msg.msg_iovlen = 3 - iovIndex;
+
+        bytes = sendmsg(socket, &msg, MSG_NOSIGNAL);
+
+        if (bytes < 0) {
+            if (errno != EINTR) {
+                status = CELIX_FILE_IO_EXCEPTION;
+            }
+        } else {
+            while (iovIndex < 3 && (size_t) bytes >= iov[iovIndex].iov_len) {
+                bytes -= iov[iovIndex].iov_len;
+                iovIndex++;
+            }
+
+            if (iovIndex < 3) {
+                iov[iovIndex].iov_base = (char*) iov[iovIndex].iov_base + bytes;
+                iov[iovIndex].iov_len -= bytes;
+            }
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,49 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef WIRING_BATCH_H_
+#define WIRING_BATCH_H_
+
+#include <stdlib.h>
+
+#include "celix_errno.h"
+
+/*
+ * Encoding of a batch of messages (requests or replies) sent as a single wiring message:
+ *
+ *   "WBT1" | count (8 hex digits) | count * ( status (8 hex digits) | length (8 hex digits) | message )
+ *
+ * The status is the replyStatus of a reply and 0 for requests. A message without content (a NULL
+ * reply) has length ffffffff. Being plain text, a batch can be handled like any other payload.
+ */
+#define WIRING_BATCH_MAGIC				"WBT1"
+#define WIRING_BATCH_HEADER_SIZE		12
+#define WIRING_BATCH_ENTRY_HEADER_SIZE	16
+#define WIRING_BATCH_NO_MESSAGE			0xffffffffU
+#define WIRING_BATCH_MAX_COUNT			65536
+
+/*
+ * Encodes count messages into a newly allocated, NUL-terminated string. statuses may be NULL,
+ * in which case every entry gets status 0.
+ */
+celix_status_t wiringBatch_encode(unsigned int count, char** messages, int* statuses, char** data, size_t* length);
+
+/*
+ * Decodes a batch. The messages and statuses arrays and every message are allocated and have to be
+ * freed by the caller, e.g. with wiringBatch_free.
+ */
+celix_status_t wiringBatch_decode(const char* data, size_t length, unsigned int* count, char*** messages, int** statuses);
+
+// like wiringBatch_decode, but a batch of requests containing a message without content is rejected
+celix_status_t wiringBatch_decodeRequests(const char* data, size_t length, unsigned int* count, char*** requests, int** statuses);
+
+void wiringBatch_free(unsigned int count, char** messages, int* statuses);
+
+/*
+ * Decodes the reply to a batch of count requests into the caller's arrays. A reply with a different
+ * number of entries is rejected.
+ */
+celix_status_t wiringBatch_decodeReplies(const char* data, size_t length, unsigned int count, char** replies, int* replyStatuses);
+
+#endif /* WIRING_BATCH_H_ */
@@ -0,0 +1,49 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef WIRING_BUFFER_H_
+#define WIRING_BUFFER_H_
+
+#include <stdlib.h>
+
+#include <curl/curl.h>
+
+#include "celix_errno.h"
+
+// capacity allocated for a buffer when no size hint is available
+#define WIRING_BUFFER_DEFAULT_CAPACITY		256
+// reused buffers larger than this are released again on reset
+#define WIRING_BUFFER_MAX_RETAINED_CAPACITY	(1024 * 1024)
+// Content-Length values above this are not trusted for pre-sizing
+#define WIRING_BUFFER_MAX_SIZE_HINT			(64 * 1024 * 1024)
+
+/*
+ * Growable, always NUL-terminated byte buffer. Appending grows the capacity
+ * geometrically; running out of memory is reported through status instead of
+ * terminating the process.
+ */
+typedef struct wiring_buffer {
+	char* data;
+	size_t size;
+	size_t capacity;
+	celix_status_t status;
+	CURL* curl;
+}* wiring_buffer_pt;
+
+celix_status_t wiringBuffer_create(size_t capacity, wiring_buffer_pt* buffer);
+celix_status_t wiringBuffer_destroy(wiring_buffer_pt buffer);
+
+celix_status_t wiringBuffer_reserve(wiring_buffer_pt buffer, size_t capacity);
+celix_status_t wiringBuffer_append(wiring_buffer_pt buffer, const void* data, size_t length);
+celix_status_t wiringBuffer_reset(wiring_buffer_pt buffer);
+celix_status_t wiringBuffer_detach(wiring_buffer_pt buffer, char** data, size_t* size);
+
+/*
+ * Installs the buffer as the write target of the given curl handle. The first
+ * chunk of the reply pre-sizes the buffer from the announced Content-Length.
+ */
+celix_status_t wiringBuffer_attachToCurl(wiring_buffer_pt buffer, CURL* curl);
+size_t wiringBuffer_curlWriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+
+#endif /* WIRING_BUFFER_H_ */
@@ -8,6 +8,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <arpa/inet.h>
 #include <sys/socket.h>
@@ -15,8 +16,27 @@
 #include <ifaddrs.h>
 
 #include "celix_errno.h"
+#include "bundle_context.h"
+#include "service_registration.h"
+
+#include "wiring_admin.h"
 
 celix_status_t wiring_getIpAddress(char* interface, char** ip);
 
+/*
+ * Returns an identifier of the host (the systemd/dbus machine id, or gethostid() as fallback)
+ * that is equal for all frameworks running on the same machine. The caller frees the string.
+ */
+celix_status_t wiring_getHostId(char** hostId);
+
+/*
+ * Registers the wiring admin service, scoped to the wiring endpoints of this framework. The tag
+ * prefixes the log lines of the calling admin.
+ */
+celix_status_t wiring_registerAdminService(bundle_context_pt context, const char* tag, wiring_admin_service_pt wiringAdminService, service_registration_pt* registration);
+
+// registers sendService as the wiring send service of the wire of its endpoint description
+celix_status_t wiring_registerSendService(bundle_context_pt context, const char* tag, wiring_send_service_pt sendService, service_registration_pt* registration);
+
 #endif /* WIRING_COMMON_UTILS_H_ */
 
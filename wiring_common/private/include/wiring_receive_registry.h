@@ -0,0 +1,110 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef WIRING_RECEIVE_REGISTRY_H_
+#define WIRING_RECEIVE_REGISTRY_H_
+
+#include <stdbool.h>
+
+#include "bundle_context.h"
+#include "celix_threads.h"
+#include "hash_map.h"
+#include "array_list.h"
+
+#include "wiring_endpoint_description.h"
+#include "wiring_stream.h"
+#include "remote_service_admin_inaetics.h"
+
+/*
+ * The receive side shared by the wiring admins: it tracks the receive services of the wires an
+ * admin exports and hands incoming requests to them, whatever transport the requests came in by.
+ */
+
+// framework property selecting how requests are spread over multiple receivers of one wire
+#define WIRING_ADMIN_DISPATCH_POLICY				"WIRING_ADMIN_DISPATCH_POLICY"
+#define WIRING_ADMIN_DISPATCH_POLICY_ROUND_ROBIN		"roundrobin"
+#define WIRING_ADMIN_DISPATCH_POLICY_LEAST_OUTSTANDING	"leastoutstanding"
+#define WIRING_ADMIN_DISPATCH_POLICY_PAYLOAD_HASH		"hash"
+
+typedef enum wiring_dispatch_policy {
+	WIRING_DISPATCH_ROUND_ROBIN,
+	WIRING_DISPATCH_LEAST_OUTSTANDING,
+	WIRING_DISPATCH_PAYLOAD_HASH
+} wiring_dispatch_policy_t;
+
+typedef struct wiring_receive_entry {
+	wiring_receive_service_pt service;
+	volatile int outstanding; //requests currently inside receive
+}* wiring_receive_entry_pt;
+
+typedef struct wiring_receive_dispatch {
+	volatile unsigned int next; //round robin position
+	array_list_pt entries;
+}* wiring_receive_dispatch_pt;
+
+/*
+ * Immutable copy of the receiveServices map. Request threads only hold snapshotLock while taking or
+ * dropping a reference; a replaced snapshot is freed once its last reader is gone.
+ */
+typedef struct wiring_receive_snapshot {
+	unsigned int refCount;
+	hash_map_pt wiringReceiveServices; //key=wireId,  value=wiring_receive_dispatch
+}* wiring_receive_snapshot_pt;
+
+typedef struct wiring_receive_registry {
+	bundle_context_pt context;
+	const char* tag; //prefix of the log lines, the TAG of the owning admin
+
+	wiring_dispatch_policy_t dispatchPolicy;
+
+	celix_thread_mutex_t trackersLock;
+	hash_map_pt trackers; //key=wiring_endpoint_desc,  value=tracker
+
+	celix_thread_mutex_t receiveServicesLock;
+	hash_map_pt receiveServices; //key=wireId,  value=wiring_receive_entries, guarded by receiveServicesLock
+
+	celix_thread_mutex_t snapshotLock;
+	celix_thread_cond_t snapshotReleased;
+	wiring_receive_snapshot_pt snapshot; //read-only copy of receiveServices used by the request path
+}* wiring_receive_registry_pt;
+
+celix_status_t wiringReceiveRegistry_create(bundle_context_pt context, const char* tag, wiring_receive_registry_pt* registry);
+// the admin has to make sure no request is handed to the registry anymore
+celix_status_t wiringReceiveRegistry_destroy(wiring_receive_registry_pt* registry);
+
+/*
+ * Creates the description of a new wire exported by this framework, carrying its wire id, the
+ * given config value and the framework uuid. The admin adds the properties telling how to reach it.
+ */
+celix_status_t wiringReceiveRegistry_createEndpoint(wiring_receive_registry_pt registry, const char* configValue, wiring_endpoint_description_pt* wEndpointDescription);
+
+// starts tracking the receive services of the wire of an exported endpoint
+celix_status_t wiringReceiveRegistry_track(wiring_receive_registry_pt registry, wiring_endpoint_description_pt wEndpointDescription);
+// returns CELIX_ILLEGAL_ARGUMENT if the endpoint is not tracked
+celix_status_t wiringReceiveRegistry_untrack(wiring_receive_registry_pt registry, wiring_endpoint_description_pt wEndpointDescription);
+// stops all trackers and drops the receivers, returns once no request uses them anymore
+celix_status_t wiringReceiveRegistry_untrackAll(wiring_receive_registry_pt registry);
+unsigned int wiringReceiveRegistry_getTrackedCount(wiring_receive_registry_pt registry);
+
+/*
+ * Hands data to a receive service of the given wire. Returns CELIX_ILLEGAL_ARGUMENT if no service
+ * is registered for the wire; otherwise *response is the reply of the service, or NULL if it has none.
+ */
+celix_status_t wiringReceiveRegistry_receive(wiring_receive_registry_pt registry, const char* wireId, char* data, char** response);
+
+/*
+ * Hands the requests of a batch (see wiring_batch.h) to the receive services one after another and
+ * encodes their replies as a batch again. Returns CELIX_ILLEGAL_ARGUMENT for an unknown wire and
+ * CELIX_INVALID_SYNTAX for a malformed batch.
+ */
+celix_status_t wiringReceiveRegistry_receiveBatch(wiring_receive_registry_pt registry, const char* wireId, char* data, size_t length, char** response);
+
+/*
+ * Hands a streamed request to the receiveStream function of a receive service of the given wire.
+ * Returns CELIX_ILLEGAL_ARGUMENT if no service is registered for the wire. *streamed is false, and
+ * nothing is read from request, if the selected service cannot stream.
+ */
+celix_status_t wiringReceiveRegistry_receiveStream(wiring_receive_registry_pt registry, const char* wireId, wiring_stream_reader_pt request, wiring_stream_writer_pt response, bool* streamed, celix_status_t* receiveStatus);
+
+#endif /* WIRING_RECEIVE_REGISTRY_H_ */
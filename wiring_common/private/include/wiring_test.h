@@ -0,0 +1,45 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef WIRING_TEST_H_
+#define WIRING_TEST_H_
+
+#include <stdio.h>
+
+/*
+ * Checks for the tests of the codecs, which run as plain executables without a framework. A failed
+ * check is reported and counted, the test goes on; main returns wiringTest_result(). A test defines
+ * WIRING_TEST_TAG before including this header.
+ */
+#ifndef WIRING_TEST_TAG
+#error "WIRING_TEST_TAG has to be defined before including wiring_test.h"
+#endif
+
+static int wiringTest_failures = 0;
+
+// index identifies the case of a table driven check, -1 if there is none
+static void wiringTest_check(int passed, const char* condition, const char* file, int line, int index) {
+	if (!passed) {
+		if (index >= 0) {
+			printf("%s: %s:%d: check failed for case %d: %s\n", WIRING_TEST_TAG, file, line, index, condition);
+		} else {
+			printf("%s: %s:%d: check failed: %s\n", WIRING_TEST_TAG, file, line, condition);
+		}
+
+		wiringTest_failures++;
+	}
+}
+
+#define CHECK(condition)				wiringTest_check((condition) ? 1 : 0, #condition, __FILE__, __LINE__, -1)
+#define CHECK_CASE(condition, index)	wiringTest_check((condition) ? 1 : 0, #condition, __FILE__, __LINE__, (index))
+
+static int wiringTest_result(void) {
+	if (wiringTest_failures > 0) {
+		printf("%s: %d checks failed\n", WIRING_TEST_TAG, wiringTest_failures);
+	}
+
+	return (wiringTest_failures > 0) ? 1 : 0;
+}
+
+#endif /* WIRING_TEST_H_ */
@@ -716,6 +716,11 @@ typedef int socklen_t;
 #define SOMAXCONN (100)
 #endif
 
+/* Backlog of the listening sockets */
+#if !defined(MGLISTENBACKLOG)
+#define MGLISTENBACKLOG SOMAXCONN
+#endif
+
 /* Size of the accepted socket queue */
 #if !defined(MGSQLEN)
 #define MGSQLEN (20)
@@ -8538,7 +8543,7 @@ static int set_ports_option(struct mg_context *ctx)
 			continue;
 		}
 
-		if (listen(so.sock, SOMAXCONN) != 0) {
+		if (listen(so.sock, MGLISTENBACKLOG) != 0) {
 
 			mg_cry(fc(ctx),
 			       "cannot listen to %.*s: %d (%s)",
@@ -0,0 +1,191 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "wiring_batch.h"
+
+static bool wiringBatch_parseHex(const char* data, unsigned int* value) {
+	bool valid = true;
+	unsigned int result = 0;
+	int i;
+
+	for (i = 0; i < 8 && valid; i++) {
+		char c = data[i];
+
+		result <<= 4;
+
+		if (c >= '0' && c <= '9') {
+			result |= c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			result |= c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			result |= c - 'A' + 10;
+		} else {
+			valid = false;
+		}
+	}
+
+	*value = result;
+
+	return valid;
+}
+
+celix_status_t wiringBatch_encode(unsigned int count, char** messages, int* statuses, char** data, size_t* length) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	size_t size = WIRING_BATCH_HEADER_SIZE;
+	unsigned int i;
+
+	if (count > WIRING_BATCH_MAX_COUNT) {
+		return CELIX_ILLEGAL_ARGUMENT;
+	}
+
+	for (i = 0; i < count; i++) {
+		size += WIRING_BATCH_ENTRY_HEADER_SIZE + ((messages[i] != NULL) ? strlen(messages[i]) : 0);
+	}
+
+	*data = malloc(size + 1);
+
+	if (*data == NULL) {
+		status = CELIX_ENOMEM;
+	} else {
+		char* pos = *data;
+
+		pos += sprintf(pos, "%s%08x", WIRING_BATCH_MAGIC, count);
+
+		for (i = 0; i < count; i++) {
+			unsigned int entryStatus = (statuses != NULL) ? (unsigned int) statuses[i] : 0;
+
+			if (messages[i] == NULL) {
+				pos += sprintf(pos, "%08x%08x", entryStatus, WIRING_BATCH_NO_MESSAGE);
+			} else {
+				size_t messageLength = strlen(messages[i]);
+
+				pos += sprintf(pos, "%08x%08x", entryStatus, (unsigned int) messageLength);
+				memcpy(pos, messages[i], messageLength);
+				pos += messageLength;
+			}
+		}
+
+		*pos = '\0';
+
+		if (length != NULL) {
+			*length = size;
+		}
+	}
+
+	return status;
+}
+
+static celix_status_t wiringBatch_decodeEntries(const char* data, size_t length, bool requests, unsigned int* count, char*** messages, int** statuses) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	unsigned int decoded = 0;
+	size_t offset = WIRING_BATCH_HEADER_SIZE;
+
+	*count = 0;
+	*messages = NULL;
+	*statuses = NULL;
+
+	if (length < WIRING_BATCH_HEADER_SIZE || strncmp(data, WIRING_BATCH_MAGIC, strlen(WIRING_BATCH_MAGIC)) != 0
+			|| !wiringBatch_parseHex(data + strlen(WIRING_BATCH_MAGIC), count) || *count > WIRING_BATCH_MAX_COUNT) {
+		*count = 0;
+		status = CELIX_ILLEGAL_ARGUMENT;
+	} else {
+		*messages = calloc((*count > 0) ? *count : 1, sizeof(char*));
+		*statuses = calloc((*count > 0) ? *count : 1, sizeof(int));
+
+		if (*messages == NULL || *statuses == NULL) {
+			status = CELIX_ENOMEM;
+		}
+	}
+
+	while (status == CELIX_SUCCESS && decoded < *count) {
+		unsigned int entryStatus = 0;
+		unsigned int messageLength = 0;
+
+		if (length - offset < WIRING_BATCH_ENTRY_HEADER_SIZE || !wiringBatch_parseHex(data + offset, &entryStatus)
+				|| !wiringBatch_parseHex(data + offset + 8, &messageLength)) {
+			status = CELIX_ILLEGAL_ARGUMENT;
+		} else {
+			offset += WIRING_BATCH_ENTRY_HEADER_SIZE;
+			(*statuses)[decoded] = (int) entryStatus;
+
+			// only a reply can be without content, receivers are never handed a NULL request
+			if (messageLength == WIRING_BATCH_NO_MESSAGE && requests) {
+				status = CELIX_ILLEGAL_ARGUMENT;
+			} else if (messageLength != WIRING_BATCH_NO_MESSAGE) {
+				if (messageLength > length - offset) {
+					status = CELIX_ILLEGAL_ARGUMENT;
+				} else if (((*messages)[decoded] = malloc(messageLength + 1)) == NULL) {
+					status = CELIX_ENOMEM;
+				} else {
+					memcpy((*messages)[decoded], data + offset, messageLength);
+					(*messages)[decoded][messageLength] = '\0';
+					offset += messageLength;
+				}
+			}
+
+			decoded++;
+		}
+	}
+
+	if (status != CELIX_SUCCESS) {
+		wiringBatch_free(*count, *messages, *statuses);
+		*count = 0;
+		*messages = NULL;
+		*statuses = NULL;
+	}
+
+	return status;
+}
+
+celix_status_t wiringBatch_decode(const char* data, size_t length, unsigned int* count, char*** messages, int** statuses) {
+	return wiringBatch_decodeEntries(data, length, false, count, messages, statuses);
+}
+
+celix_status_t wiringBatch_decodeRequests(const char* data, size_t length, unsigned int* count, char*** requests, int** statuses) {
+	return wiringBatch_decodeEntries(data, length, true, count, requests, statuses);
+}
+
+void wiringBatch_free(unsigned int count, char** messages, int* statuses) {
+	unsigned int i;
+
+	if (messages != NULL) {
+		for (i = 0; i < count; i++) {
+			free(messages[i]);
+		}
+		free(messages);
+	}
+
+	free(statuses);
+}
+
+celix_status_t wiringBatch_decodeReplies(const char* data, size_t length, unsigned int count, char** replies, int* replyStatuses) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	unsigned int decodedCount = 0;
+	char** messages = NULL;
+	int* statuses = NULL;
+
+	status = wiringBatch_decode(data, length, &decodedCount, &messages, &statuses);
+
+	if (status == CELIX_SUCCESS && decodedCount != count) {
+		printf("WIRING_BATCH: Got %u replies for a batch of %u requests\n", decodedCount, count);
+		wiringBatch_free(decodedCount, messages, statuses);
+		status = CELIX_ILLEGAL_STATE;
+	} else if (status == CELIX_SUCCESS) {
+		memcpy(replies, messages, count * sizeof(char*));
+		memcpy(replyStatuses, statuses, count * sizeof(int));
+
+		// the replies themselves are handed over to the caller
+		free(messages);
+		free(statuses);
+	}
+
+	return status;
+}
@@ -0,0 +1,162 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "wiring_buffer.h"
+
+celix_status_t wiringBuffer_create(size_t capacity, wiring_buffer_pt* buffer) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	*buffer = calloc(1, sizeof(**buffer));
+
+	if (!*buffer) {
+		status = CELIX_ENOMEM;
+	} else {
+		status = wiringBuffer_reserve(*buffer, (capacity > 0) ? capacity : WIRING_BUFFER_DEFAULT_CAPACITY);
+
+		if (status != CELIX_SUCCESS) {
+			free(*buffer);
+			*buffer = NULL;
+		}
+	}
+
+	return status;
+}
+
+celix_status_t wiringBuffer_destroy(wiring_buffer_pt buffer) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	if (buffer != NULL) {
+		free(buffer->data);
+		free(buffer);
+	}
+
+	return status;
+}
+
+celix_status_t wiringBuffer_reserve(wiring_buffer_pt buffer, size_t capacity) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	// one additional byte is always kept for the terminating NUL
+	if (buffer->data == NULL || capacity >= buffer->capacity) {
+		char* data = realloc(buffer->data, capacity + 1);
+
+		if (data == NULL) {
+			status = CELIX_ENOMEM;
+		} else {
+			if (buffer->data == NULL) {
+				data[0] = '\0';
+			}
+			buffer->data = data;
+			buffer->capacity = capacity + 1;
+		}
+	}
+
+	return status;
+}
+
+celix_status_t wiringBuffer_append(wiring_buffer_pt buffer, const void* data, size_t length) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	size_t required = buffer->size + length;
+
+	if (required >= buffer->capacity) {
+		size_t capacity = buffer->capacity * 2;
+
+		if (capacity < WIRING_BUFFER_DEFAULT_CAPACITY) {
+			capacity = WIRING_BUFFER_DEFAULT_CAPACITY;
+		}
+		while (capacity <= required) {
+			capacity *= 2;
+		}
+
+		status = wiringBuffer_reserve(buffer, capacity);
+	}
+
+	if (status == CELIX_SUCCESS) {
+		memcpy(&(buffer->data[buffer->size]), data, length);
+		buffer->size += length;
+		buffer->data[buffer->size] = '\0';
+	} else {
+		buffer->status = status;
+	}
+
+	return status;
+}
+
+celix_status_t wiringBuffer_reset(wiring_buffer_pt buffer) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	// do not let a single large reply pin its memory for the lifetime of the buffer
+	if (buffer->capacity > WIRING_BUFFER_MAX_RETAINED_CAPACITY + 1) {
+		free(buffer->data);
+		buffer->data = NULL;
+		buffer->capacity = 0;
+		status = wiringBuffer_reserve(buffer, WIRING_BUFFER_DEFAULT_CAPACITY);
+	}
+
+	if (buffer->data != NULL) {
+		buffer->data[0] = '\0';
+	}
+
+	buffer->size = 0;
+	buffer->status = status;
+	buffer->curl = NULL;
+
+	return status;
+}
+
+celix_status_t wiringBuffer_detach(wiring_buffer_pt buffer, char** data, size_t* size) {
+	celix_status_t status = buffer->status;
+
+	if (status == CELIX_SUCCESS) {
+		*data = buffer->data;
+
+		if (size != NULL) {
+			*size = buffer->size;
+		}
+
+		buffer->data = NULL;
+		buffer->size = 0;
+		buffer->capacity = 0;
+		buffer->curl = NULL;
+	}
+
+	return status;
+}
+
+celix_status_t wiringBuffer_attachToCurl(wiring_buffer_pt buffer, CURL* curl) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	buffer->curl = curl;
+
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, wiringBuffer_curlWriteCallback);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *) buffer);
+
+	return status;
+}
+
+size_t wiringBuffer_curlWriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+	size_t realsize = size * nmemb;
+	wiring_buffer_pt buffer = (wiring_buffer_pt) userp;
+
+	if (buffer->size == 0 && buffer->curl != NULL) {
+		double contentLength = -1;
+
+		if (curl_easy_getinfo(buffer->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &contentLength) == CURLE_OK && contentLength > 0 && contentLength <= WIRING_BUFFER_MAX_SIZE_HINT) {
+			// a failing hint is not fatal, append below will retry with the actual chunk size
+			wiringBuffer_reserve(buffer, (size_t) contentLength);
+		}
+	}
+
+	if (wiringBuffer_append(buffer, contents, realsize) != CELIX_SUCCESS) {
+		printf("WIRING_BUFFER: not enough memory to store %zu bytes of reply\n", realsize);
+		// returning less than realsize aborts the transfer with CURLE_WRITE_ERROR
+		return 0;
+	}
+
+	return realsize;
+}
@@ -2,6 +2,9 @@
  * Licensed under Apache License v2. See LICENSE for more information.
  */
 
+#include "constants.h"
+#include "remote_constants.h"
+
 #include "wiring_common_utils.h"
 
 celix_status_t wiring_getIpAddress(char* interface, char** ip) {
@@ -34,3 +37,81 @@ celix_status_t wiring_getIpAddress(char* interface, char** ip) {
 
 	return status;
 }
+
+celix_status_t wiring_getHostId(char** hostId) {
+	celix_status_t status = CELIX_BUNDLE_EXCEPTION;
+
+	const char* machineIdFiles[] = { "/etc/machine-id", "/var/lib/dbus/machine-id", NULL };
+	char machineId[64];
+	int i;
+
+	for (i = 0; machineIdFiles[i] != NULL && status != CELIX_SUCCESS; i++) {
+		FILE* file = fopen(machineIdFiles[i], "r");
+
+		if (file != NULL) {
+			if (fgets(machineId, sizeof(machineId), file) != NULL) {
+				machineId[strcspn(machineId, " \r\n")] = '\0';
+
+				if (strlen(machineId) > 0) {
+					*hostId = strdup(machineId);
+					status = (*hostId != NULL) ? CELIX_SUCCESS : CELIX_ENOMEM;
+				}
+			}
+			fclose(file);
+		}
+	}
+
+	if (status != CELIX_SUCCESS) {
+		snprintf(machineId, sizeof(machineId), "%08lx", (unsigned long) gethostid());
+		*hostId = strdup(machineId);
+		status = (*hostId != NULL) ? CELIX_SUCCESS : CELIX_ENOMEM;
+	}
+
+	return status;
+}
+
+celix_status_t wiring_registerAdminService(bundle_context_pt context, const char* tag, wiring_admin_service_pt wiringAdminService, service_registration_pt* registration) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	char *uuid = NULL;
+	status = bundleContext_getProperty(context, (char *) OSGI_FRAMEWORK_FRAMEWORK_UUID, &uuid);
+
+	if (status == CELIX_SUCCESS && uuid == NULL) {
+		status = CELIX_ILLEGAL_STATE;
+	}
+
+	if (status != CELIX_SUCCESS) {
+		printf("%s: no framework UUID defined\n", tag);
+	} else {
+		size_t len = 4 + strlen(OSGI_RSA_ENDPOINT_FRAMEWORK_UUID) + strlen(uuid);
+		char scope[len + 1];
+
+		snprintf(scope, sizeof(scope), "(%s=%s)", OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, uuid);
+
+		properties_pt props = properties_create();
+		properties_set(props, (char *) INAETICS_WIRING_ADMIN_SCOPE, scope);
+
+		status = bundleContext_registerService(context, (char*) INAETICS_WIRING_ADMIN, wiringAdminService, props, registration);
+	}
+
+	return status;
+}
+
+celix_status_t wiring_registerSendService(bundle_context_pt context, const char* tag, wiring_send_service_pt sendService, service_registration_pt* registration) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	char* wireId = properties_get(sendService->wiringEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+
+	properties_pt props = properties_create();
+	properties_set(props, (char*) INAETICS_WIRING_WIRE_ID, wireId);
+
+	status = bundleContext_registerService(context, (char *) INAETICS_WIRING_SEND_SERVICE, sendService, props, registration);
+
+	if (status == CELIX_SUCCESS) {
+		printf("%s: SEND SERVICE successfully registered w/ wireId %s\n", tag, wireId);
+	} else {
+		printf("%s: could not register SEND SERVICE w/ wireId %s\n", tag, wireId);
+	}
+
+	return status;
+}
@@ -0,0 +1,587 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constants.h"
+#include "remote_constants.h"
+#include "service_tracker.h"
+#include "utils.h"
+
+#include "wiring_admin.h"
+#include "wiring_batch.h"
+#include "wiring_receive_registry.h"
+
+static celix_status_t wiringReceiveRegistry_receiveAdding(void * handle, service_reference_pt reference, void **service);
+static celix_status_t wiringReceiveRegistry_receiveAdded(void * handle, service_reference_pt reference, void * service);
+static celix_status_t wiringReceiveRegistry_receiveModified(void * handle, service_reference_pt reference, void * service);
+static celix_status_t wiringReceiveRegistry_receiveRemoved(void * handle, service_reference_pt reference, void * service);
+
+static celix_status_t wiringReceiveRegistry_publishSnapshot(wiring_receive_registry_pt registry);
+static wiring_receive_dispatch_pt wiringReceiveRegistry_acquireDispatch(wiring_receive_registry_pt registry, const char* wireId, wiring_receive_snapshot_pt* snapshot);
+static void wiringReceiveRegistry_releaseSnapshot(wiring_receive_registry_pt registry, wiring_receive_snapshot_pt snapshot);
+static void wiringReceiveRegistry_destroySnapshot(wiring_receive_snapshot_pt snapshot);
+static void wiringReceiveRegistry_destroyEntries(hash_map_pt receiveServices);
+static wiring_receive_entry_pt wiringReceiveRegistry_selectReceiver(wiring_receive_registry_pt registry, wiring_receive_dispatch_pt dispatch, char* data);
+static void wiringReceiveRegistry_dispatch(wiring_receive_registry_pt registry, wiring_receive_dispatch_pt dispatch, char* data, char** response);
+
+celix_status_t wiringReceiveRegistry_create(bundle_context_pt context, const char* tag, wiring_receive_registry_pt* registry) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	*registry = calloc(1, sizeof(**registry));
+
+	if (!*registry) {
+		status = CELIX_ENOMEM;
+	} else {
+		char* dispatchPolicy = NULL;
+
+		(*registry)->context = context;
+		(*registry)->tag = tag;
+		(*registry)->dispatchPolicy = WIRING_DISPATCH_ROUND_ROBIN;
+
+		bundleContext_getProperty(context, WIRING_ADMIN_DISPATCH_POLICY, &dispatchPolicy);
+
+		if (dispatchPolicy != NULL) {
+			if (strcmp(dispatchPolicy, WIRING_ADMIN_DISPATCH_POLICY_LEAST_OUTSTANDING) == 0) {
+				(*registry)->dispatchPolicy = WIRING_DISPATCH_LEAST_OUTSTANDING;
+			} else if (strcmp(dispatchPolicy, WIRING_ADMIN_DISPATCH_POLICY_PAYLOAD_HASH) == 0) {
+				(*registry)->dispatchPolicy = WIRING_DISPATCH_PAYLOAD_HASH;
+			} else if (strcmp(dispatchPolicy, WIRING_ADMIN_DISPATCH_POLICY_ROUND_ROBIN) != 0) {
+				printf("%s: Unknown dispatch policy %s, using %s\n", tag, dispatchPolicy, WIRING_ADMIN_DISPATCH_POLICY_ROUND_ROBIN);
+			}
+		}
+
+		(*registry)->trackers = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL);
+		(*registry)->receiveServices = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+		celixThreadMutex_create(&(*registry)->trackersLock, NULL);
+		celixThreadMutex_create(&(*registry)->receiveServicesLock, NULL);
+		celixThreadMutex_create(&(*registry)->snapshotLock, NULL);
+		celixThreadCondition_init(&(*registry)->snapshotReleased, NULL);
+	}
+
+	return status;
+}
+
+celix_status_t wiringReceiveRegistry_destroy(wiring_receive_registry_pt* registry) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	wiringReceiveRegistry_untrackAll(*registry);
+
+	hashMap_destroy((*registry)->trackers, false, false);
+	hashMap_destroy((*registry)->receiveServices, false, false);
+
+	// untrackAll published an empty snapshot, so there is nothing left to free
+	celixThreadCondition_destroy(&(*registry)->snapshotReleased);
+	celixThreadMutex_destroy(&(*registry)->snapshotLock);
+	celixThreadMutex_destroy(&(*registry)->receiveServicesLock);
+	celixThreadMutex_destroy(&(*registry)->trackersLock);
+
+	free(*registry);
+	*registry = NULL;
+
+	return status;
+}
+
+celix_status_t wiringReceiveRegistry_createEndpoint(wiring_receive_registry_pt registry, const char* configValue, wiring_endpoint_description_pt* wEndpointDescription) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	char* fwuuid = NULL;
+	properties_pt props = NULL;
+
+	status = bundleContext_getProperty(registry->context, OSGI_FRAMEWORK_FRAMEWORK_UUID, &fwuuid);
+
+	if (status == CELIX_SUCCESS && fwuuid == NULL) {
+		status = CELIX_ILLEGAL_STATE;
+	}
+
+	if (status == CELIX_SUCCESS) {
+		props = properties_create();
+		status = (props != NULL) ? wiringEndpointDescription_create(NULL, props, wEndpointDescription) : CELIX_ENOMEM;
+	}
+
+	if (status == CELIX_SUCCESS) {
+		properties_set(props, WIRING_ADMIN_PROPERTIES_CONFIG_KEY, (char*) configValue);
+		properties_set(props, (char*) OSGI_RSA_ENDPOINT_FRAMEWORK_UUID, fwuuid);
+
+		printf("%s: wiringEndpointDescription_create w/ wireId %s started\n", registry->tag, properties_get(props, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY));
+	} else {
+		printf("%s: Cannot create Wiring Endpoint\n", registry->tag);
+
+		if (props != NULL) {
+			properties_destroy(props);
+		}
+	}
+
+	return status;
+}
+
+celix_status_t wiringReceiveRegistry_track(wiring_receive_registry_pt registry, wiring_endpoint_description_pt wEndpointDescription) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	char* wireId = properties_get(wEndpointDescription->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
+	service_tracker_customizer_pt customizer = NULL;
+	service_tracker_pt tracker = NULL;
+
+	status = serviceTrackerCustomizer_create(registry, wiringReceiveRegistry_receiveAdding, wiringReceiveRegistry_receiveAdded, wiringReceiveRegistry_receiveModified, wiringReceiveRegistry_receiveRemoved, &customizer);
+
+	if (status == CELIX_SUCCESS) {
+		char filter[512];
+		snprintf(filter, 512, "(&(%s=%s)(%s=%s))", (char*) OSGI_FRAMEWORK_OBJECTCLASS, (char*) INAETICS_WIRING_RECEIVE_SERVICE, (char*) INAETICS_WIRING_WIRE_ID, wireId);
+
+		status = serviceTracker_createWithFilter(registry->context, filter, customizer, &tracker);
+	}
+
+	if (status == CELIX_SUCCESS) {
+		status = serviceTracker_open(tracker);
+
+		if (status == CELIX_SUCCESS) {
+			celixThreadMutex_lock(&registry->trackersLock);
+			hashMap_put(registry->trackers, wEndpointDescription, tracker);
+			celixThreadMutex_unlock(&registry->trackersLock);
+
+			printf("%s: WiringReceiveTracker w/ wireId %s started\n", registry->tag, wireId);
+		} else {
+			serviceTracker_destroy(tracker);
+		}
+	}
+
+	return status;
+}
+
+celix_status_t wiringReceiveRegistry_untrack(wiring_receive_registry_pt registry, wiring_endpoint_description_pt wEndpointDescription) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	celixThreadMutex_lock(&registry->trackersLock);
+	service_tracker_pt tracker = hashMap_remove(registry->trackers, wEndpointDescription);
+	celixThreadMutex_unlock(&registry->trackersLock);
+
+	if (tracker == NULL) {
+		status = CELIX_ILLEGAL_ARGUMENT;
+	} else if (serviceTracker_close(tracker) == CELIX_SUCCESS) {
+		serviceTracker_destroy(tracker);
+	}
+
+	return status;
+}
+
+celix_status_t wiringReceiveRegistry_untrackAll(wiring_receive_registry_pt registry) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	celixThreadMutex_lock(&registry->trackersLock);
+
+	hash_map_iterator_pt iter = hashMapIterator_create(registry->trackers);
+
+	while (hashMapIterator_hasNext(iter)) {
+		service_tracker_pt tracker = (service_tracker_pt) hashMapIterator_nextValue(iter);
+
+		if (serviceTracker_close(tracker) == CELIX_SUCCESS) {
+			serviceTracker_destroy(tracker);
+		}
+	}
+	hashMapIterator_destroy(iter);
+
+	hashMap_clear(registry->trackers, false, false);
+
+	celixThreadMutex_unlock(&registry->trackersLock);
+
+	celixThreadMutex_lock(&registry->receiveServicesLock);
+
+	// publish an empty snapshot first, the entries may only be freed once no request uses them
+	hash_map_pt receiveServices = registry->receiveServices;
+	registry->receiveServices = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+	status = wiringReceiveRegistry_publishSnapshot(registry);
+
+	wiringReceiveRegistry_destroyEntries(receiveServices);
+
+	celixThreadMutex_unlock(&registry->receiveServicesLock);
+
+	return status;
+}
+
+unsigned int wiringReceiveRegistry_getTrackedCount(wiring_receive_registry_pt registry) {
+	unsigned int count = 0;
+
+	celixThreadMutex_lock(&registry->trackersLock);
+	count = hashMap_size(registry->trackers);
+	celixThreadMutex_unlock(&registry->trackersLock);
+
+	return count;
+}
+
+static celix_status_t wiringReceiveRegistry_receiveAdding(void * handle, service_reference_pt reference, void **service) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	wiring_receive_registry_pt registry = handle;
+
+	status = bundleContext_getService(registry->context, reference, service);
+
+	return status;
+}
+
+static celix_status_t wiringReceiveRegistry_receiveAdded(void * handle, service_reference_pt reference, void * service) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	wiring_receive_registry_pt registry = handle;
+	wiring_receive_service_pt wiringReceiveService = (wiring_receive_service_pt) service;
+
+	celixThreadMutex_lock(&registry->receiveServicesLock);
+
+	array_list_pt wiringReceiveEntries = hashMap_get(registry->receiveServices, wiringReceiveService->wireId);
+	wiring_receive_entry_pt wiringReceiveEntry = calloc(1, sizeof(*wiringReceiveEntry));
+
+	if (!wiringReceiveEntry) {
+		status = CELIX_ENOMEM;
+	} else {
+		printf("%s: wiringReceiveService w/ wireId %s added\n", registry->tag, wiringReceiveService->wireId);
+
+		wiringReceiveEntry->service = wiringReceiveService;
+
+		if (wiringReceiveEntries == NULL) {
+			arrayList_create(&wiringReceiveEntries);
+			hashMap_put(registry->receiveServices, wiringReceiveService->wireId, wiringReceiveEntries);
+		}
+
+		arrayList_add(wiringReceiveEntries, wiringReceiveEntry);
+
+		status = wiringReceiveRegistry_publishSnapshot(registry);
+	}
+
+	celixThreadMutex_unlock(&registry->receiveServicesLock);
+
+	return status;
+}
+
+static celix_status_t wiringReceiveRegistry_receiveModified(void * handle, service_reference_pt reference, void * service) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	return status;
+}
+
+static celix_status_t wiringReceiveRegistry_receiveRemoved(void * handle, service_reference_pt reference, void * service) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	wiring_receive_registry_pt registry = handle;
+	wiring_receive_service_pt wiringReceiveService = (wiring_receive_service_pt) service;
+
+	celixThreadMutex_lock(&registry->receiveServicesLock);
+
+	array_list_pt wiringReceiveEntries = hashMap_get(registry->receiveServices, wiringReceiveService->wireId);
+	wiring_receive_entry_pt wiringReceiveEntry = NULL;
+	int i;
+
+	for (i = 0; wiringReceiveEntries != NULL && i < arrayList_size(wiringReceiveEntries); i++) {
+		wiring_receive_entry_pt entry = arrayList_get(wiringReceiveEntries, i);
+
+		if (entry->service == wiringReceiveService) {
+			wiringReceiveEntry = arrayList_remove(wiringReceiveEntries, i);
+			break;
+		}
+	}
+
+	if (wiringReceiveEntry != NULL) {
+		printf("%s: wiringReceiveService w/ wireId %s removed\n", registry->tag, wiringReceiveService->wireId);
+
+		// the key is owned by one of the services, so re-key the list with one that stays
+		hashMap_remove(registry->receiveServices, wiringReceiveService->wireId);
+
+		if (arrayList_size(wiringReceiveEntries) == 0) {
+			arrayList_destroy(wiringReceiveEntries);
+		} else {
+			wiring_receive_entry_pt remaining = arrayList_get(wiringReceiveEntries, 0);
+			hashMap_put(registry->receiveServices, remaining->service->wireId, wiringReceiveEntries);
+		}
+
+		// returns only after no request thread can still call into the removed service
+		status = wiringReceiveRegistry_publishSnapshot(registry);
+
+		free(wiringReceiveEntry);
+	} else {
+		printf("%s: wiringReceiveService w/ wireId %s not found\n", registry->tag, wiringReceiveService->wireId);
+	}
+
+	celixThreadMutex_unlock(&registry->receiveServicesLock);
+
+	return status;
+}
+
+/*
+ * Replaces the snapshot used by the request path with a copy of receiveServices and waits until all
+ * readers of the previous snapshot are done. Caller must hold receiveServicesLock.
+ */
+static celix_status_t wiringReceiveRegistry_publishSnapshot(wiring_receive_registry_pt registry) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	wiring_receive_snapshot_pt snapshot = NULL;
+	wiring_receive_snapshot_pt oldSnapshot = NULL;
+
+	if (hashMap_size(registry->receiveServices) > 0) {
+		snapshot = calloc(1, sizeof(*snapshot));
+
+		if (!snapshot) {
+			status = CELIX_ENOMEM;
+		} else {
+			snapshot->wiringReceiveServices = hashMap_create(utils_stringHash, NULL, utils_stringEquals, NULL);
+
+			hash_map_iterator_pt iter = hashMapIterator_create(registry->receiveServices);
+			while (hashMapIterator_hasNext(iter)) {
+				hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
+				array_list_pt wiringReceiveEntries = hashMapEntry_getValue(entry);
+				wiring_receive_dispatch_pt dispatch = calloc(1, sizeof(*dispatch));
+				int i;
+
+				if (!dispatch) {
+					status = CELIX_ENOMEM;
+					break;
+				}
+
+				// the entries are shared with the registry, so outstanding counts survive a new snapshot
+				arrayList_create(&dispatch->entries);
+				for (i = 0; i < arrayList_size(wiringReceiveEntries); i++) {
+					arrayList_add(dispatch->entries, arrayList_get(wiringReceiveEntries, i));
+				}
+
+				hashMap_put(snapshot->wiringReceiveServices, hashMapEntry_getKey(entry), dispatch);
+			}
+			hashMapIterator_destroy(iter);
+
+			if (status != CELIX_SUCCESS) {
+				wiringReceiveRegistry_destroySnapshot(snapshot);
+				snapshot = NULL;
+			}
+		}
+	}
+
+	// on allocation failure an empty snapshot is published, a stale one could reference removed services
+	celixThreadMutex_lock(&registry->snapshotLock);
+
+	oldSnapshot = registry->snapshot;
+	registry->snapshot = snapshot;
+
+	while (oldSnapshot != NULL && oldSnapshot->refCount > 0) {
+		celixThreadCondition_wait(&registry->snapshotReleased, &registry->snapshotLock);
+	}
+
+	celixThreadMutex_unlock(&registry->snapshotLock);
+
+	wiringReceiveRegistry_destroySnapshot(oldSnapshot);
+
+	return status;
+}
+
+// returns the receivers of the wire, or NULL; the snapshot has to be released also when NULL is returned
+static wiring_receive_dispatch_pt wiringReceiveRegistry_acquireDispatch(wiring_receive_registry_pt registry, const char* wireId, wiring_receive_snapshot_pt* snapshot) {
+	wiring_receive_dispatch_pt dispatch = NULL;
+
+	celixThreadMutex_lock(&registry->snapshotLock);
+
+	*snapshot = registry->snapshot;
+
+	if (*snapshot != NULL) {
+		(*snapshot)->refCount++;
+	}
+
+	celixThreadMutex_unlock(&registry->snapshotLock);
+
+	if (*snapshot != NULL) {
+		dispatch = hashMap_get((*snapshot)->wiringReceiveServices, (void*) wireId);
+	}
+
+	return dispatch;
+}
+
+static void wiringReceiveRegistry_releaseSnapshot(wiring_receive_registry_pt registry, wiring_receive_snapshot_pt snapshot) {
+	if (snapshot != NULL) {
+		celixThreadMutex_lock(&registry->snapshotLock);
+
+		snapshot->refCount--;
+
+		if (snapshot->refCount == 0 && snapshot != registry->snapshot) {
+			celixThreadCondition_broadcast(&registry->snapshotReleased);
+		}
+
+		celixThreadMutex_unlock(&registry->snapshotLock);
+	}
+}
+
+static void wiringReceiveRegistry_destroySnapshot(wiring_receive_snapshot_pt snapshot) {
+	if (snapshot != NULL) {
+		hash_map_iterator_pt iter = hashMapIterator_create(snapshot->wiringReceiveServices);
+
+		while (hashMapIterator_hasNext(iter)) {
+			wiring_receive_dispatch_pt dispatch = hashMapIterator_nextValue(iter);
+
+			arrayList_destroy(dispatch->entries);
+			free(dispatch);
+		}
+
+		hashMapIterator_destroy(iter);
+		hashMap_destroy(snapshot->wiringReceiveServices, false, false);
+		free(snapshot);
+	}
+}
+
+static void wiringReceiveRegistry_destroyEntries(hash_map_pt receiveServices) {
+	hash_map_iterator_pt iter = hashMapIterator_create(receiveServices);
+
+	while (hashMapIterator_hasNext(iter)) {
+		array_list_pt wiringReceiveEntries = hashMapIterator_nextValue(iter);
+		int i;
+
+		for (i = 0; i < arrayList_size(wiringReceiveEntries); i++) {
+			free(arrayList_get(wiringReceiveEntries, i));
+		}
+		arrayList_destroy(wiringReceiveEntries);
+	}
+
+	hashMapIterator_destroy(iter);
+	hashMap_destroy(receiveServices, false, false);
+}
+
+static wiring_receive_entry_pt wiringReceiveRegistry_selectReceiver(wiring_receive_registry_pt registry, wiring_receive_dispatch_pt dispatch, char* data) {
+	unsigned int size = arrayList_size(dispatch->entries);
+	unsigned int index = 0;
+
+	if (size > 1) {
+		switch (registry->dispatchPolicy) {
+			case WIRING_DISPATCH_LEAST_OUTSTANDING: {
+				unsigned int start = __sync_fetch_and_add(&dispatch->next, 1);
+				unsigned int i;
+				int least = -1;
+
+				// start at a rotating position so idle receivers share the load as well
+				for (i = 0; i < size; i++) {
+					wiring_receive_entry_pt entry = arrayList_get(dispatch->entries, (start + i) % size);
+
+					if (least < 0 || entry->outstanding < least) {
+						least = entry->outstanding;
+						index = (start + i) % size;
+					}
+				}
+				break;
+			}
+			case WIRING_DISPATCH_PAYLOAD_HASH:
+				// the payload of a streamed request is not known up front, it is dispatched round robin
+				if (data != NULL) {
+					index = utils_stringHash(data) % size;
+					break;
+				}
+				/* no break */
+			case WIRING_DISPATCH_ROUND_ROBIN:
+			default:
+				index = __sync_fetch_and_add(&dispatch->next, 1) % size;
+				break;
+		}
+	}
+
+	return arrayList_get(dispatch->entries, index);
+}
+
+// hands a request to one of the receivers of a wire, a failing receiver leaves response NULL
+static void wiringReceiveRegistry_dispatch(wiring_receive_registry_pt registry, wiring_receive_dispatch_pt dispatch, char* data, char** response) {
+	wiring_receive_entry_pt entry = wiringReceiveRegistry_selectReceiver(registry, dispatch, data);
+	wiring_receive_service_pt wiringReceiveService = entry->service;
+
+	__sync_add_and_fetch(&entry->outstanding, 1);
+
+	if (wiringReceiveService->receive(wiringReceiveService->handle, data, response) != CELIX_SUCCESS) {
+		*response = NULL;
+	}
+
+	__sync_sub_and_fetch(&entry->outstanding, 1);
+}
+
+celix_status_t wiringReceiveRegistry_receive(wiring_receive_registry_pt registry, const char* wireId, char* data, char** response) {
+	celix_status_t status = CELIX_ILLEGAL_ARGUMENT;
+
+	wiring_receive_snapshot_pt snapshot = NULL;
+	wiring_receive_dispatch_pt dispatch = wiringReceiveRegistry_acquireDispatch(registry, wireId, &snapshot);
+
+	*response = NULL;
+
+	if (dispatch != NULL) {
+		wiringReceiveRegistry_dispatch(registry, dispatch, data, response);
+		status = CELIX_SUCCESS;
+	}
+
+	wiringReceiveRegistry_releaseSnapshot(registry, snapshot);
+
+	return status;
+}
+
+// the whole batch is dispatched from one snapshot, so it sees one set of receivers
+celix_status_t wiringReceiveRegistry_receiveBatch(wiring_receive_registry_pt registry, const char* wireId, char* data, size_t length, char** response) {
+	celix_status_t status = CELIX_SUCCESS;
+
+	unsigned int count = 0;
+	char** requests = NULL;
+	int* statuses = NULL;
+	char** replies = NULL;
+	unsigned int i;
+
+	wiring_receive_snapshot_pt snapshot = NULL;
+	wiring_receive_dispatch_pt dispatch = wiringReceiveRegistry_acquireDispatch(registry, wireId, &snapshot);
+
+	*response = NULL;
+
+	if (dispatch == NULL) {
+		status = CELIX_ILLEGAL_ARGUMENT;
+	} else if (wiringBatch_decodeRequests(data, length, &count, &requests, &statuses) != CELIX_SUCCESS) {
+		status = CELIX_INVALID_SYNTAX;
+	} else {
+		replies = calloc((count > 0) ? count : 1, sizeof(char*));
+
+		if (replies == NULL) {
+			status = CELIX_ENOMEM;
+		}
+	}
+
+	for (i = 0; status == CELIX_SUCCESS && i < count; i++) {
+		wiringReceiveRegistry_dispatch(registry, dispatch, requests[i], &replies[i]);
+		statuses[i] = (replies[i] != NULL) ? 0 : 204;
+	}
+
+	if (status == CELIX_SUCCESS) {
+		status = wiringBatch_encode(count, replies, statuses, response, NULL);
+	}
+
+	wiringReceiveRegistry_releaseSnapshot(registry, snapshot);
+
+	wiringBatch_free(count, replies, NULL);
+	wiringBatch_free(count, requests, statuses);
+
+	return status;
+}
+
+celix_status_t wiringReceiveRegistry_receiveStream(wiring_receive_registry_pt registry, const char* wireId, wiring_stream_reader_pt request, wiring_stream_writer_pt response, bool* streamed, celix_status_t* receiveStatus) {
+	celix_status_t status = CELIX_ILLEGAL_ARGUMENT;
+
+	wiring_receive_snapshot_pt snapshot = NULL;
+	wiring_receive_dispatch_pt dispatch = wiringReceiveRegistry_acquireDispatch(registry, wireId, &snapshot);
+
+	*streamed = false;
+
+	if (dispatch != NULL) {
+		wiring_receive_entry_pt entry = wiringReceiveRegistry_selectReceiver(registry, dispatch, NULL);
+		wiring_receive_service_pt wiringReceiveService = entry->service;
+
+		if (wiringReceiveService->receiveStream != NULL) {
+			__sync_add_and_fetch(&entry->outstanding, 1);
+
+			*receiveStatus = wiringReceiveService->receiveStream(wiringReceiveService->handle, request, response);
+			*streamed = true;
+
+			__sync_sub_and_fetch(&entry->outstanding, 1);
+		}
+
+		status = CELIX_SUCCESS;
+	}
+
+	wiringReceiveRegistry_releaseSnapshot(registry, snapshot);
+
+	return status;
+}
@@ -6,6 +6,7 @@
 #define WIRING_ADMIN_H_
 
 #include "wiring_endpoint_listener.h"
+#include "wiring_stream.h"
 
 #include "celix_errno.h"
 
@@ -23,11 +24,19 @@ static const char * const INAETICS_WIRING_ADMIN_SCOPE = "wiring.admin.scope";
 #define WIRING_ADMIN_PROPERTIES_CONFIG_KEY 				"inaetics.wiring.config"
 #define WIRING_ADMIN_PROPERTIES_SECURE_KEY 				"inaetics.wiring.secure"
 
+// config of the shared memory wiring admin, which only reaches frameworks on the same host
+#define WIRING_ADMIN_PROPERTIES_SHM_CONFIG_VALUE			"inaetics.wiring.shm"
+
 typedef struct wiring_admin *wiring_admin_pt;
 
 struct wiring_admin_service {
 	wiring_admin_pt admin;
 
+	/*
+	 * exports a new wire, *wEndpoint is set to its description. The shared memory admin also accepts
+	 * the description of a wire exported by another admin in *wEndpoint: it serves that wire as well
+	 * and adds its properties to the description, which stays owned by the other admin.
+	 */
 	celix_status_t (*exportWiringEndpoint)(wiring_admin_pt admin, wiring_endpoint_description_pt* wEndpoint);
 	celix_status_t (*removeExportedWiringEndpoint)(wiring_admin_pt admin, wiring_endpoint_description_pt wEndpoint);
 	celix_status_t (*getWiringAdminProperties)(wiring_admin_pt admin, properties_pt* admin_properties);
@@ -44,10 +53,39 @@ static const char * const INAETICS_WIRING_WIRE_ID = "wire.id";
 
 typedef struct wiring_send_service *wiring_send_service_pt;
 
+/*
+ * Completion callback of sendAsync. It is called exactly once per accepted request, from a thread
+ * owned by the wiring admin, with the same status/reply/replyStatus semantics as send. The reply
+ * (if any) is owned by the callback. Callbacks must not block, as they delay other pending requests.
+ */
+typedef void (*wiring_send_callback_pt)(void* userdata, celix_status_t status, char* reply, int replyStatus);
+
 struct wiring_send_service {
 	wiring_admin_pt admin;
 	wiring_endpoint_description_pt wiringEndpointDescription;
 	celix_status_t (*send)(wiring_send_service_pt sendService, char *request, char **reply, int* replyStatus);
+	// as send, for callers that already know the request is requestLength bytes (not counting its terminating NUL)
+	celix_status_t (*sendSized)(wiring_send_service_pt sendService, char *request, size_t requestLength, char **reply, int* replyStatus);
+	// the request is copied; if a status other than CELIX_SUCCESS is returned, the callback is not invoked
+	celix_status_t (*sendAsync)(wiring_send_service_pt sendService, char *request, wiring_send_callback_pt callback, void* userdata);
+	/*
+	 * sends count requests as a single wiring message, the receiver handles them in order. replies and
+	 * replyStatuses have count entries and get the result of each request, as send would return it.
+	 * The returned status only covers the transfer of the batch as a whole.
+	 */
+	celix_status_t (*sendBatch)(wiring_send_service_pt sendService, char **requests, unsigned int count, char **replies, int* replyStatuses);
+	/*
+	 * the request is copied; returns as soon as it is queued or written, a reply of the receiver is discarded.
+	 * CELIX_SUCCESS does not mean the request was delivered: the receiving admin acknowledges it before
+	 * dispatching and only logs requests for an unknown wire, so a dropped request cannot be told apart
+	 * from a handled one. Use send or sendAsync when the outcome matters.
+	 */
+	celix_status_t (*sendOneway)(wiring_send_service_pt sendService, char *request);
+	/*
+	 * optional, NULL if the wiring admin cannot stream. The request is read from request and the reply
+	 * written to reply in bounded chunks, so the size of a message is not limited by memory.
+	 */
+	celix_status_t (*sendStream)(wiring_send_service_pt sendService, wiring_stream_reader_pt request, wiring_stream_writer_pt reply, int* replyStatus);
 };
 
 #endif /* WIRING_ADMIN_H_ */
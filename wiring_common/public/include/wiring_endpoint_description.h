@@ -11,6 +11,10 @@
 
 #define WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY			"org.inaetics.remote.admin.wiring.wireId"
 #define WIRING_ENDPOINT_DESCRIPTION_HTTP_URL_KEY		"inaetics.wiring.http.url"
+#define WIRING_ENDPOINT_DESCRIPTION_TCP_URL_KEY			"inaetics.wiring.tcp.url"
+#define WIRING_ENDPOINT_DESCRIPTION_SHM_NAME_KEY		"inaetics.wiring.shm.name"
+#define WIRING_ENDPOINT_DESCRIPTION_HOST_ID_KEY			"inaetics.wiring.host.id"
+#define WIRING_ENDPOINT_DESCRIPTION_COMPRESSION_KEY		"inaetics.wiring.compression"
 
 
 struct wiring_endpoint_description {
@@ -0,0 +1,30 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+#ifndef WIRING_STREAM_H_
+#define WIRING_STREAM_H_
+
+#include <stdlib.h>
+
+#include "celix_errno.h"
+
+/*
+ * Source of a streamed message. read fills buffer with at most size bytes and sets length to the
+ * number of bytes read; a length of 0 marks the end of the message.
+ */
+typedef struct wiring_stream_reader {
+	void* handle;
+	celix_status_t (*read)(void* handle, char* buffer, size_t size, size_t* length);
+} * wiring_stream_reader_pt;
+
+/*
+ * Sink of a streamed message. write is called for every chunk of data, in order; a status other
+ * than CELIX_SUCCESS aborts the transfer.
+ */
+typedef struct wiring_stream_writer {
+	void* handle;
+	celix_status_t (*write)(void* handle, const char* data, size_t length);
+} * wiring_stream_writer_pt;
+
+#endif /* WIRING_STREAM_H_ */
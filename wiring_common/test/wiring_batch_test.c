@@ -0,0 +1,138 @@
+/**
+ * Licensed under Apache License v2. See LICENSE for more information.
+ */
+
+/*
+ * Round trips of the batch codec shared by the wiring admins (see wiring_batch.h), and the
+ * malformed batches a receiver has to reject.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "wiring_batch.h"
+
+#define WIRING_TEST_TAG             "WIRING_BATCH_TEST"
+
+#include "wiring_test.h"
+
+static void wiringBatchTest_roundTrip(void) {
+    char big[4096];
+    char* messages[] = { "first", "", NULL, big, "{\"m\":\"x\",\"a\":[1,2]}" };
+    int statuses[] = { 0, 204, 404, 0, 413 };
+    unsigned int count = sizeof(messages) / sizeof(messages[0]);
+
+    char* data = NULL;
+    size_t length = 0;
+    unsigned int decodedCount = 0;
+    char** decoded = NULL;
+    int* decodedStatuses = NULL;
+    unsigned int i;
+
+    memset(big, 'b', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+
+    CHECK(wiringBatch_encode(count, messages, statuses, &data, &length) == CELIX_SUCCESS);
+    CHECK(data != NULL && length == strlen(data));
+    CHECK(wiringBatch_decode(data, length, &decodedCount, &decoded, &decodedStatuses) == CELIX_SUCCESS);
+    CHECK(decodedCount == count);
+
+    for (i = 0; decoded != NULL && i < count && i < decodedCount; i++) {
+        CHECK(decodedStatuses[i] == statuses[i]);
+
+        if (messages[i] == NULL) {
+            CHECK(decoded[i] == NULL);
+        } else {
+            CHECK(decoded[i] != NULL && strcmp(decoded[i], messages[i]) == 0);
+        }
+    }
+
+    wiringBatch_free(decodedCount, decoded, decodedStatuses);
+    free(data);
+}
+
+static void wiringBatchTest_requests(void) {
+    char* requests[] = { "a", "bc" };
+
+    char* data = NULL;
+    size_t length = 0;
+    unsigned int count = 0;
+    char** decoded = NULL;
+    int* statuses = NULL;
+
+    // requests are encoded without statuses
+    CHECK(wiringBatch_encode(2, requests, NULL, &data, &length) == CELIX_SUCCESS);
+    CHECK(data != NULL && strcmp(data, WIRING_BATCH_MAGIC "00000002" "0000000000000001a" "0000000000000002bc") == 0);
+    CHECK(wiringBatch_decode(data, length, &count, &decoded, &statuses) == CELIX_SUCCESS);
+    CHECK(count == 2 && statuses[0] == 0 && statuses[1] == 0);
+
+    wiringBatch_free(count, decoded, statuses);
+    free(data);
+
+    // an empty batch is valid
+    CHECK(wiringBatch_encode(0, requests, NULL, &data, &length) == CELIX_SUCCESS);
+    CHECK(wiringBatch_decode(data, length, &count, &decoded, &statuses) == CELIX_SUCCESS);
+    CHECK(count == 0);
+
+    wiringBatch_free(count, decoded, statuses);
+    free(data);
+}
+
+static void wiringBatchTest_replies(void) {
+    char* messages[] = { "one", NULL, "three" };
+    int statuses[] = { 0, 204, 0 };
+    char* replies[3] = { NULL, NULL, NULL };
+    int replyStatuses[3] = { -1, -1, -1 };
+
+    char* data = NULL;
+    size_t length = 0;
+    unsigned int i;
+
+    CHECK(wiringBatch_encode(3, messages, statuses, &data, &length) == CELIX_SUCCESS);
+    CHECK(wiringBatch_decodeReplies(data, length, 3, replies, replyStatuses) == CELIX_SUCCESS);
+    CHECK(replies[0] != NULL && strcmp(replies[0], "one") == 0);
+    CHECK(replies[1] == NULL && replyStatuses[1] == 204);
+    CHECK(replies[2] != NULL && strcmp(replies[2], "three") == 0);
+
+    for (i = 0; i < 3; i++) {
+        free(replies[i]);
+    }
+
+    // the reply has to answer every request of the batch
+    CHECK(wiringBatch_decodeReplies(data, length, 2, replies, replyStatuses) == CELIX_ILLEGAL_STATE);
+
+    free(data);
+}
+
+static void wiringBatchTest_malformed(void) {
+    const char* batches[] = {
+        "",
+        "WBT1",
+        "XXXX00000001" "0000000000000001a",
+        "WBT1zzzzzzzz",
+        "WBT100000002" "0000000000000001a",
+        "WBT100000001" "00000000000000ffa",
+        "WBT100000001" "00000000000000",
+        "WBT1ffffffff",
+        "WBT100000001" "00000000ffffffff",
+        NULL };
+    int i;
+
+    for (i = 0; batches[i] != NULL; i++) {
+        unsigned int count = 1;
+        char** messages = (char**) &count;
+        int* statuses = (int*) &count;
+
+        CHECK_CASE(wiringBatch_decodeRequests(batches[i], strlen(batches[i]), &count, &messages, &statuses) == CELIX_ILLEGAL_ARGUMENT, i);
+        CHECK_CASE(count == 0 && messages == NULL && statuses == NULL, i);
+    }
+}
+
+int main(int argc, char** argv) {
+    wiringBatchTest_roundTrip();
+    wiringBatchTest_requests();
+    wiringBatchTest_replies();
+    wiringBatchTest_malformed();
+
+    return wiringTest_result();
+}
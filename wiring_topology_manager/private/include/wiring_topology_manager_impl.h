@@ -24,6 +24,8 @@ struct wiring_topology_manager {
     //  key = srvcproperties_hash, val = hashmap (key = Wa, val = endpoint)
     celix_thread_mutex_t exportedWiringEndpointsLock;
     hash_map_pt exportedWiringEndpoints;
+    //  key = endpoint exported by another Wa, val = same-host Wa serving it as well
+    hash_map_pt sameHostExports;
 
     array_list_pt waitingForExport;
     array_list_pt waitingForImport;
@@ -31,6 +33,7 @@ struct wiring_topology_manager {
     celix_thread_mutex_t importedWiringEndpointsLock;
     hash_map_pt importedWiringEndpoints;
 
+    char* hostId;
 };
 
 celix_status_t wiringTopologyManager_create(bundle_context_pt context, wiring_topology_manager_pt *manager);
@@ -16,6 +16,7 @@
 #include "wiring_topology_manager_impl.h"
 #include "wiring_admin.h"
 #include "wiring_endpoint_description.h"
+#include "wiring_common_utils.h"
 
 typedef struct wiring_endpoint_registration {
     wiring_endpoint_description_pt wiringEndpointDescription;
@@ -30,6 +31,9 @@ bool properties_match(properties_pt properties, properties_pt reference);
 celix_status_t wiringTopologyManager_WiringAdminServiceExportWiringEndpoint(wiring_topology_manager_pt manager, wiring_admin_service_pt wiringAdminService, properties_pt srvcProperties,
         wiring_endpoint_description_pt* wEndpoint);
 
+static bool wiringTopologyManager_isSameHostWA(wiring_admin_service_pt wiringAdminService);
+static void wiringTopologyManager_addSameHostExport(wiring_topology_manager_pt manager, wiring_admin_service_pt wiringAdminService, wiring_endpoint_description_pt wEndpoint);
+
 celix_status_t wiringTopologyManager_create(bundle_context_pt context, wiring_topology_manager_pt *manager) {
     celix_status_t status = CELIX_SUCCESS;
 
@@ -52,6 +56,9 @@ celix_status_t wiringTopologyManager_create(bundle_context_pt context, wiring_to
     (*manager)->listenerList = hashMap_create(serviceReference_hashCode, NULL, serviceReference_equals2, NULL);
     (*manager)->importedWiringEndpoints = hashMap_create(wiringEndpointDescription_hash, NULL, wiringEndpointDescription_equals, NULL); // key=wiring_endpoint_description_pt, value=array_list_pt wadmins
     (*manager)->exportedWiringEndpoints = hashMap_create(wiringTopologyManager_srvcProperties_hash, NULL, wiringTopologyManager_srvcProperties_equals, NULL); // key=properties_pt, value=(hash_map_pt  key=wadmin, value=wendpoint)
+    (*manager)->sameHostExports = hashMap_create(NULL, NULL, NULL, NULL);
+
+    status = wiring_getHostId(&(*manager)->hostId);
 
     return status;
 }
@@ -95,10 +102,12 @@ celix_status_t wiringTopologyManager_destroy(wiring_topology_manager_pt manager)
     hashMapIterator_destroy(iter);
 
     hashMap_destroy(manager->exportedWiringEndpoints, false, false);
+    hashMap_destroy(manager->sameHostExports, false, false);
 
     celixThreadMutex_unlock(&manager->exportedWiringEndpointsLock);
     celixThreadMutex_destroy(&manager->exportedWiringEndpointsLock);
 
+    free(manager->hostId);
     free(manager);
 
     return status;
@@ -297,6 +306,8 @@ celix_status_t wiringTopologyManager_WiringAdminServiceExportWiringEndpoint(wiri
             if (status != CELIX_SUCCESS) {
                 printf("WTM: export of WiringAdmin failed\n");
             } else {
+                // before the listeners publish the endpoint, so importers on this host see the shortcut
+                wiringTopologyManager_addSameHostExport(manager, wiringAdminService, *wEndpoint);
 
                 char* serviceId = properties_get(srvcProperties, "service.id");
                 properties_set((*wEndpoint)->properties, "requested.service.id", serviceId);
@@ -347,16 +358,23 @@ celix_status_t wiringTopologyManager_exportWiringEndpoint(wiring_topology_manage
 
             if (listSize > 0) {
 
+                int pass = 0;
+
                 wiringAdminList = hashMap_create(NULL, NULL, NULL, NULL);
                 hashMap_put(manager->exportedWiringEndpoints, srvcProperties, wiringAdminList);
 
-                for (; listCnt < listSize && (wEndpoint == NULL); ++listCnt) {
+                // a same-host Wa cannot be reached from other hosts, so it only exports a wire when no other Wa can
+                for (; pass < 2 && (wEndpoint == NULL); ++pass) {
+                    for (listCnt = 0; listCnt < listSize && (wEndpoint == NULL); ++listCnt) {
 
-                    wiring_admin_service_pt wiringAdminService = (wiring_admin_service_pt) arrayList_get(wiringAdmins, listCnt);
+                        wiring_admin_service_pt wiringAdminService = (wiring_admin_service_pt) arrayList_get(wiringAdmins, listCnt);
 
-                    status = wiringTopologyManager_WiringAdminServiceExportWiringEndpoint(manager, wiringAdminService, srvcProperties, &wEndpoint);
-                    if (status == CELIX_SUCCESS) {
-                        hashMap_put(wiringAdminList, wiringAdminService, wEndpoint);
+                        if (wiringTopologyManager_isSameHostWA(wiringAdminService) == (pass == 1)) {
+                            status = wiringTopologyManager_WiringAdminServiceExportWiringEndpoint(manager, wiringAdminService, srvcProperties, &wEndpoint);
+                            if (status == CELIX_SUCCESS) {
+                                hashMap_put(wiringAdminList, wiringAdminService, wEndpoint);
+                            }
+                        }
                     }
                 }
 
@@ -415,6 +433,13 @@ celix_status_t wiringTopologyManager_removeExportedWiringEndpoint(wiring_topolog
                 wiring_admin_service_pt wiringAdminService = hashMapEntry_getKey(wiringAdminEntry);
                 wiring_endpoint_description_pt wEndpoint = hashMapEntry_getValue(wiringAdminEntry);
 
+                // the same-host Wa goes first, the endpoint is freed by the Wa that exported it
+                wiring_admin_service_pt sameHostWA = hashMap_remove(manager->sameHostExports, wEndpoint);
+
+                if (sameHostWA != NULL && sameHostWA->removeExportedWiringEndpoint(sameHostWA->admin, wEndpoint) != CELIX_SUCCESS) {
+                    status = CELIX_BUNDLE_EXCEPTION;
+                }
+
                 if (wiringAdminService->removeExportedWiringEndpoint(wiringAdminService->admin, wEndpoint) != CELIX_SUCCESS) {
                     status = CELIX_BUNDLE_EXCEPTION;
                 }
@@ -478,29 +503,51 @@ celix_status_t wiringTopologyManager_checkWiringEndpointForImportService(wiring_
        array_list_pt wiringAdminList = (array_list_pt) hashMap_get(manager->importedWiringEndpoints, wiringEndpointDesc);
        char* wireId = properties_get(wiringEndpointDesc->properties, WIRING_ENDPOINT_DESCRIPTION_WIRE_ID_KEY);
 
+       char* hostId = properties_get(wiringEndpointDesc->properties, WIRING_ENDPOINT_DESCRIPTION_HOST_ID_KEY);
+       char* endpointFwuuid = properties_get(wiringEndpointDesc->properties, (char*) OSGI_RSA_ENDPOINT_FRAMEWORK_UUID);
+       char* fwuuid = NULL;
+
+       bundleContext_getProperty(manager->context, OSGI_FRAMEWORK_FRAMEWORK_UUID, &fwuuid);
+
+       // wires of this framework are left to the Wa that exported them, which calls the receiver directly
+       bool sameFramework = (fwuuid != NULL && endpointFwuuid != NULL && strcmp(fwuuid, endpointFwuuid) == 0);
+       bool sameHost = (hostId != NULL && manager->hostId != NULL && strcmp(hostId, manager->hostId) == 0);
+       int pass = (sameHost && !sameFramework) ? 0 : 1;
+
        if (listSize == 0) {
            printf("WTM: There are no WiringAdmins available for wireId %s\n", wireId);
        }
 
-       for (; listCnt < listSize; ++listCnt) {
-           wiring_admin_service_pt wiringAdminService = (wiring_admin_service_pt) arrayList_get(localWAs, listCnt);
+       // a wire exported by another framework on this host is imported by a same-host Wa if possible, whatever Wa exported it
+       for (; pass < 2 && status != CELIX_SUCCESS; ++pass) {
+           for (listCnt = 0; listCnt < listSize; ++listCnt) {
+               wiring_admin_service_pt wiringAdminService = (wiring_admin_service_pt) arrayList_get(localWAs, listCnt);
 
-           if (arrayList_contains(wiringAdminList, wiringAdminService)) {
-               printf("WTM: WiringEndpoint %s is already imported by WiringAdminService %p\n", wireId, wiringAdminService);
-               status = CELIX_SUCCESS;
+               if (arrayList_contains(wiringAdminList, wiringAdminService)) {
+                   printf("WTM: WiringEndpoint %s is already imported by WiringAdminService %p\n", wireId, wiringAdminService);
+                   status = CELIX_SUCCESS;
 
-           } else {
-               status = wiringTopologyManager_checkWiringAdminForImportWiringEndpoint(manager, wiringAdminService, wiringEndpointDesc);
+               } else if (pass == 0) {
+                   if (wiringTopologyManager_isSameHostWA(wiringAdminService)
+                           && wiringAdminService->importWiringEndpoint(wiringAdminService->admin, wiringEndpointDesc) == CELIX_SUCCESS) {
+                       printf("WTM: WiringEndpoint %s of this host imported by WiringAdminService %p\n", wireId, wiringAdminService);
+                       arrayList_add(wiringAdminList, wiringAdminService);
 
-               if (status == CELIX_SUCCESS) {
-                   printf("WTM: WiringEndpoint %s sucessfully imported by WiringAdminService %p\n", wireId, wiringAdminService);
-                   arrayList_add(wiringAdminList, wiringAdminService);
+                       status = CELIX_SUCCESS;
+                   }
+               } else {
+                   status = wiringTopologyManager_checkWiringAdminForImportWiringEndpoint(manager, wiringAdminService, wiringEndpointDesc);
 
+                   if (status == CELIX_SUCCESS) {
+                       printf("WTM: WiringEndpoint %s sucessfully imported by WiringAdminService %p\n", wireId, wiringAdminService);
+                       arrayList_add(wiringAdminList, wiringAdminService);
 
-                   status = CELIX_SUCCESS;
-               }
-               else {
-                   printf("WTM: WiringEndpoint %s imported by WiringAdminService %p FAILED\n", wireId, wiringAdminService);
+
+                       status = CELIX_SUCCESS;
+                   }
+                   else {
+                       printf("WTM: WiringEndpoint %s imported by WiringAdminService %p FAILED\n", wireId, wiringAdminService);
+                   }
                }
            }
        }
@@ -607,6 +654,40 @@ celix_status_t wiringTopologyManager_removeImportedWiringEndpoint(wiring_topolog
     return status;
 }
 
+static bool wiringTopologyManager_isSameHostWA(wiring_admin_service_pt wiringAdminService) {
+    properties_pt adminProperties = NULL;
+    char* wiringConfigAdmin = NULL;
+
+    wiringAdminService->getWiringAdminProperties(wiringAdminService->admin, &adminProperties);
+
+    if (adminProperties != NULL) {
+        wiringConfigAdmin = properties_get(adminProperties, WIRING_ADMIN_PROPERTIES_CONFIG_KEY);
+    }
+
+    return (wiringConfigAdmin != NULL && strcmp(wiringConfigAdmin, WIRING_ADMIN_PROPERTIES_SHM_CONFIG_VALUE) == 0);
+}
+
+/* lets a same-host Wa serve a wire exported by another Wa as well, importers on this host then prefer it */
+static void wiringTopologyManager_addSameHostExport(wiring_topology_manager_pt manager, wiring_admin_service_pt wiringAdminService, wiring_endpoint_description_pt wEndpoint) {
+    array_list_pt wiringAdmins = NULL;
+    int listCnt = 0;
+
+    if (!wiringTopologyManager_isSameHostWA(wiringAdminService)) {
+        wiringTopologyManager_getWAs(manager, &wiringAdmins);
+
+        for (; listCnt < arrayList_size(wiringAdmins) && !hashMap_containsKey(manager->sameHostExports, wEndpoint); ++listCnt) {
+            wiring_admin_service_pt sameHostWA = (wiring_admin_service_pt) arrayList_get(wiringAdmins, listCnt);
+            wiring_endpoint_description_pt sharedEndpoint = wEndpoint;
+
+            if (wiringTopologyManager_isSameHostWA(sameHostWA) && sameHostWA->exportWiringEndpoint(sameHostWA->admin, &sharedEndpoint) == CELIX_SUCCESS) {
+                hashMap_put(manager->sameHostExports, wEndpoint, sameHostWA);
+            }
+        }
+
+        arrayList_destroy(wiringAdmins);
+    }
+}
+
 /* informs about a sucessful exported wire */
 celix_status_t wiringTopologyManager_notifyListenersWiringEndpointAdded(wiring_topology_manager_pt manager, wiring_endpoint_description_pt wEndpoint) {
     celix_status_t status = CELIX_SUCCESS;
@@ -144,6 +144,12 @@ celix_status_t wiringTopologyManager_waRemoved(void * handle, service_reference_
 
         if (hashMap_containsKey(wiringAdminMap, wiringAdminService)) {
             wiring_endpoint_description_pt wEndpoint = (wiring_endpoint_description_pt) hashMap_remove(wiringAdminMap, wiringAdminService);
+            wiring_admin_service_pt sameHostWA = hashMap_remove(manager->sameHostExports, wEndpoint);
+
+            // a same-host Wa serving the wire as well lets go of it before the endpoint is freed
+            if (sameHostWA != NULL) {
+                sameHostWA->removeExportedWiringEndpoint(sameHostWA->admin, wEndpoint);
+            }
 
             status = wiringTopologyManager_notifyListenersWiringEndpointRemoved(manager, wEndpoint);
 
@@ -157,6 +163,19 @@ celix_status_t wiringTopologyManager_waRemoved(void * handle, service_reference_
 
     hashMapIterator_destroy(iter);
 
+    /* wires of other WAs the removed WA served as well stay exported by their own WA */
+    iter = hashMapIterator_create(manager->sameHostExports);
+    while (hashMapIterator_hasNext(iter)) {
+        hash_map_entry_pt entry = hashMapIterator_nextEntry(iter);
+
+        if (hashMapEntry_getValue(entry) == wiringAdminService) {
+            wiringAdminService->removeExportedWiringEndpoint(wiringAdminService->admin, hashMapEntry_getKey(entry));
+            hashMapIterator_remove(iter);
+        }
+    }
+
+    hashMapIterator_destroy(iter);
+
     celixThreadMutex_unlock(&manager->exportedWiringEndpointsLock);
 
     /* Check if the added WA can match one of the imported WiringEndpoints */